@@ -0,0 +1,110 @@
+#pragma once
+
+#include "star_windowing/InputCodes.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+namespace star::windowing
+{
+struct InputBinding
+{
+    Input_Source source;
+    int code; // GLFW key or mouse button code
+    uint8_t action;
+};
+
+/// <summary>
+/// Maps keys and mouse buttons to application defined actions and tracks per-frame action state. Bindings are
+/// compiled into a dense table indexed by input code, so processing an input is a single lookup no matter how many
+/// bindings exist.
+/// </summary>
+class ActionMap
+{
+  public:
+    using ActionID = uint8_t;
+    static constexpr size_t MaxActions = 64;
+    static constexpr ActionID Unbound = 0xFF;
+    using LookupTable = std::array<ActionID, NumInputCodes>;
+
+    /// <summary>
+    /// Build the lookup table for a binding list. Intended to be evaluated at compile time, an invalid binding then
+    /// fails the build.
+    /// </summary>
+    template <size_t N> static constexpr LookupTable CompileBindings(const std::array<InputBinding, N> &bindings)
+    {
+        LookupTable table{};
+        for (auto &entry : table)
+        {
+            entry = Unbound;
+        }
+
+        for (const auto &binding : bindings)
+        {
+            if (!IsValidInputCode(binding.source, binding.code) || binding.action >= MaxActions)
+            {
+                throw std::out_of_range("Input binding is outside of the supported key/button/action range");
+            }
+            table[GetInputCodeIndex(binding.source, binding.code)] = binding.action;
+        }
+
+        return table;
+    }
+
+    ActionMap() : ActionMap(CompileBindings(std::array<InputBinding, 0>{}))
+    {
+    }
+    explicit ActionMap(const LookupTable &bindings) : m_bindings(bindings)
+    {
+    }
+
+    /// <summary>
+    /// Bind an input to an action at runtime, replacing whatever it was bound to before
+    /// </summary>
+    void bind(const Input_Source &source, const int &code, const ActionID &action);
+
+    void unbind(const Input_Source &source, const int &code);
+
+    /// <summary>
+    /// Feed a press or release of an input. Called by InteractivityBus for every registered map.
+    /// </summary>
+    void processInput(const Input_Source &source, const int &code, const bool &isPressed);
+
+    /// <summary>
+    /// Clear the pressed/released edges from the previous frame
+    /// </summary>
+    void beginFrame()
+    {
+        m_pressedThisFrame = 0;
+        m_releasedThisFrame = 0;
+    }
+
+    bool isHeld(const ActionID &action) const
+    {
+        return (m_held >> action) & 1u;
+    }
+
+    bool wasPressed(const ActionID &action) const
+    {
+        return (m_pressedThisFrame >> action) & 1u;
+    }
+
+    bool wasReleased(const ActionID &action) const
+    {
+        return (m_releasedThisFrame >> action) & 1u;
+    }
+
+  private:
+    LookupTable m_bindings;
+    std::array<bool, NumInputCodes> m_inputDown{};
+    // several inputs can drive the same action, it is only released once all of them are
+    std::array<uint8_t, MaxActions> m_holdCount{};
+    uint64_t m_held = 0, m_pressedThisFrame = 0, m_releasedThisFrame = 0;
+
+    void pressAction(const ActionID &action);
+
+    void releaseAction(const ActionID &action);
+};
+} // namespace star::windowing
@@ -1,13 +1,11 @@
 #pragma once
 
 #include "StarCamera.hpp"
-#include "Time.hpp"
 
 #include <star_common/EventBus.hpp>
-#include <star_windowing/policy/HandleKeyPressPolicy.hpp>
-#include <star_windowing/policy/HandleKeyReleasePolicy.hpp>
-#include <star_windowing/policy/HandleMouseButtonPolicy.hpp>
-#include <star_windowing/policy/HandleMouseMovementPolicy.hpp>
+#include <star_windowing/ActionMap.hpp>
+#include <star_windowing/SimulationClock.hpp>
+#include <star_windowing/policy/HandleInputPolicy.hpp>
 
 #include <glm/glm.hpp>
 #include <iostream>
@@ -18,12 +16,23 @@ namespace star::windowing
 /// Camera with default controls
 /// </summary>
 class BasicCamera : public StarCamera,
-                    private HandleMouseMovementPolicy<BasicCamera>,
-                    private HandleMouseButtonPolicy<BasicCamera>,
-                    private HandleKeyPressPolicy<BasicCamera>,
-                    private HandleKeyReleasePolicy<BasicCamera>
+                    private HandleInputPolicy<BasicCamera, event::MouseMovement, event::MouseButton, event::MouseDelta>
 {
   public:
+    enum Action : ActionMap::ActionID
+    {
+        move_left,
+        move_right,
+        move_forward,
+        move_back
+    };
+
+    static constexpr std::array<InputBinding, 4> DefaultBindings{{{Input_Source::key, GLFW_KEY_A, move_left},
+                                                                   {Input_Source::key, GLFW_KEY_D, move_right},
+                                                                   {Input_Source::key, GLFW_KEY_W, move_forward},
+                                                                   {Input_Source::key, GLFW_KEY_S, move_back}}};
+    static constexpr ActionMap::LookupTable DefaultBindingLookup = ActionMap::CompileBindings(DefaultBindings);
+
     BasicCamera();
     BasicCamera(const uint32_t &width, const uint32_t &height);
     BasicCamera(const uint32_t &width, const uint32_t &height, const float &horizontalFieldOfView,
@@ -33,6 +42,9 @@ class BasicCamera : public StarCamera,
     virtual ~BasicCamera();
     void init(common::EventBus &eventBus);
 
+    /// <summary>
+    /// Apply input gathered since the last call and record whether this frame in flight needs the camera refreshed
+    /// </summary>
     virtual void frameUpdate(core::device::DeviceContext &context, const uint8_t &frameInFlightIndex) override;
 
     // void onScroll(double xoffset, double yoffset) override {};
@@ -57,18 +69,42 @@ class BasicCamera : public StarCamera,
         movementSpeed = newSpeed;
     }
 
-  protected:
-    void onKeyRelease(const int &key, const int &scancode, const int &mods);
+    /// <summary>
+    /// Length of one movement simulation step. Movement is simulated at this fixed rate and interpolated for each
+    /// rendered frame. Throws if the step is not positive.
+    /// </summary>
+    void setSimulationStep(const double &stepSeconds)
+    {
+        m_simulationClock.setStepSeconds(stepSeconds);
+    }
 
-    // /// <summary>
-    // /// Key callback for camera object. Implements default controls for the camera.
-    // /// </summary>
-    // /// <param name="key"></param>
-    // /// <param name="scancode"></param>
-    // /// <param name="action"></param>
-    // /// <param name="mods"></param>
-    void onKeyPress(const int &key, const int &scancode, const int &mods);
+    /// <summary>
+    /// Whether the camera changed since the data for this frame in flight was last refreshed. Valid after frameUpdate
+    /// for the frame. The camera buffer update checks it and skips the write, and any work depending on it, when false.
+    /// </summary>
+    bool needsUpload(const uint8_t &frameInFlightIndex) const
+    {
+        return (m_uploadFrames >> frameInFlightIndex) & 1u;
+    }
+
+    /// <summary>
+    /// Flag a change made through StarCamera directly, such as a new projection after a resize, so every frame in
+    /// flight picks it up. Moves and rotations made that way are noticed on the next frameUpdate without this.
+    /// </summary>
+    void markDirty()
+    {
+        m_dirtyFrames = AllFramesDirty;
+    }
+
+    /// <summary>
+    /// Controls for the camera. Can be used to rebind movement at runtime.
+    /// </summary>
+    ActionMap &getActionMap()
+    {
+        return m_actions;
+    }
 
+  protected:
     // /// <summary>
     // /// Mouse callback for camera objects. Implements default controls for the camera.
     // /// </summary>
@@ -84,21 +120,49 @@ class BasicCamera : public StarCamera,
     // /// <param name="mods"></param>
     void onMouseButtonAction(const int &button, const int &action, const int &mods);
 
+    /// <summary>
+    /// Relative motion callback used while the cursor is captured by the window. Look is applied without needing a
+    /// click.
+    /// </summary>
+    void onMouseDelta(const double &xdelta, const double &ydelta);
+
   private:
-    friend class HandleMouseMovementPolicy<BasicCamera>;
-    friend class HandleMouseButtonPolicy<BasicCamera>;
-    friend class HandleKeyPressPolicy<BasicCamera>;
-    friend class HandleKeyReleasePolicy<BasicCamera>;
-    Time time = Time();
+    static constexpr uint32_t AllFramesDirty = ~0u;
+
+    using InputPolicy = HandleInputPolicy<BasicCamera, event::MouseMovement, event::MouseButton, event::MouseDelta>;
+    friend InputPolicy;
+
+    SimulationClock m_simulationClock;
+    ActionMap m_actions{DefaultBindingLookup};
 
     float movementSpeed = 1000.0f;
     float sensitivity = 0.1f;
-    // previous mouse coordinates from GLFW
-    float prevX, prevY, xMovement, yMovement;
+    // previous mouse coordinates from GLFW, and the motion accumulated since the last frame update
+    float prevX = 0.0f, prevY = 0.0f, xMovement = 0.0f, yMovement = 0.0f;
+    // relative motion from cursor capture, consumed on the next frame update
+    float capturedXMovement = 0.0f, capturedYMovement = 0.0f;
     // control information for camera
     float pitch = -0.f, yaw = -90.0f;
-    bool moveLeft = false, moveRight = false, moveForward = false, moveBack = false;
     bool m_init = false;
     bool click = false;
+    // last two simulated positions, the camera is placed between them each frame
+    glm::vec3 m_previousPosition{0.0f}, m_currentPosition{0.0f}, m_renderedPosition{0.0f};
+    bool m_hasSimulatedPosition = false;
+    // forward vector as of the last frame update, to notice rotations made through StarCamera
+    glm::vec3 m_renderedForward{0.0f};
+    // bit per frame in flight whose copy of the camera is out of date
+    uint32_t m_dirtyFrames = AllFramesDirty;
+    // bit per frame in flight which was refreshed by its last frameUpdate
+    uint32_t m_uploadFrames = AllFramesDirty;
+
+    void applyLookRotation(const float &yawChange, const float &pitchChange);
+
+    void simulateMovement();
+
+    glm::vec3 calculateStepDisplacement(const float &stepSeconds);
+
+    static float ClampPitch(const float &pitch);
+
+    static glm::vec3 CalculateDirection(const float &yaw, const float &pitch);
 };
 } // namespace star::windowing
\ No newline at end of file
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace star::windowing
+{
+/// <summary>
+/// Collects the regions of the window which changed. Every swapchain image keeps the damage reported since it was
+/// last drawn, as it still holds contents from several frames ago, while the regions handed to the presentation engine
+/// only cover what changed since the previous frame.
+/// </summary>
+class DamageTracker
+{
+  public:
+    /// <summary>
+    /// Start over for a new set of swapchain images, all of which need a full redraw
+    /// </summary>
+    void reset(const uint32_t &numImages, const vk::Extent2D &extent);
+
+    void addDamage(const vk::Rect2D &region);
+
+    void damageAll();
+
+    /// <summary>
+    /// Collect the damage to redraw and present for the image about to be drawn. Damage reported afterwards goes to
+    /// the next frame.
+    /// </summary>
+    void beginImage(const uint32_t &imageIndex);
+
+    /// <summary>
+    /// Whether anything was reported since the previous beginImage, without any the window already shows the latest
+    /// contents
+    /// </summary>
+    bool hasFrameDamage() const
+    {
+        return m_frameDamage.full || !m_frameDamage.regions.empty();
+    }
+
+    bool isFullRedraw() const
+    {
+        return m_redrawFull;
+    }
+
+    /// <summary>
+    /// Regions of the current image to redraw, only meaningful when isFullRedraw is false
+    /// </summary>
+    const std::vector<vk::Rect2D> &getRedrawRegions() const
+    {
+        return m_redrawRegions;
+    }
+
+    /// <summary>
+    /// Bounding box of the regions to redraw
+    /// </summary>
+    vk::Rect2D getRedrawBounds() const;
+
+    bool isFullPresent() const
+    {
+        return m_presentFull;
+    }
+
+    const std::vector<vk::Rect2D> &getPresentRegions() const
+    {
+        return m_presentRegions;
+    }
+
+  private:
+    // past this many rectangles, damage is merged into its bounding box to keep the cost of tracking it down
+    static constexpr size_t MaxRegions = 16;
+
+    struct Damage
+    {
+        bool full = true;
+        std::vector<vk::Rect2D> regions;
+
+        void add(const vk::Rect2D &region);
+    };
+
+    vk::Extent2D m_extent{};
+    std::vector<Damage> m_images;
+    Damage m_frameDamage;
+    bool m_redrawFull = true, m_presentFull = true;
+    std::vector<vk::Rect2D> m_redrawRegions, m_presentRegions;
+
+    static vk::Rect2D Union(const vk::Rect2D &a, const vk::Rect2D &b);
+};
+} // namespace star::windowing
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace star::windowing
+{
+/// <summary>
+/// Sent once to each consumer as it connects, along with the file descriptors of every image's memory followed by the
+/// file descriptor of the timeline semaphore when semaphoreExported is set.
+/// </summary>
+struct FrameExportRingInfo
+{
+    static constexpr uint32_t Magic = 0x58465453; // "STFX"
+    static constexpr uint32_t Version = 1;
+
+    uint32_t magic = Magic;
+    uint32_t version = Version;
+    uint32_t numImages = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    // VkFormat of the images, which are 2D, single mip, optimal tiling and imported as VK_IMAGE_USAGE_SAMPLED_BIT |
+    // VK_IMAGE_USAGE_TRANSFER_SRC_BIT
+    uint32_t format = 0;
+    uint64_t allocationSize = 0;
+    // memory and semaphore handles are opaque fds, only valid on the same device and driver
+    uint8_t deviceUUID[16]{};
+    uint8_t driverUUID[16]{};
+    uint32_t semaphoreExported = 0;
+};
+
+/// <summary>
+/// Sent for each exported frame. When the semaphore was not exported, the frame is only sent once the copy completed.
+/// </summary>
+struct FrameExportMessage
+{
+    uint32_t slot = 0;
+    // wait for the exported timeline semaphore to reach this value before reading the slot
+    uint64_t timelineValue = 0;
+};
+
+/// <summary>
+/// Sent back by the consumer once it no longer reads from a slot. Slots are not written again until every consumer
+/// released them, frames are dropped from the export instead of stalling rendering.
+/// </summary>
+struct FrameExportRelease
+{
+    uint32_t slot = 0;
+};
+
+/// <summary>
+/// Non-blocking unix domain socket server handing exported frames to consumer processes. Uses SOCK_SEQPACKET so each
+/// message is received whole, file descriptors travel with the message through SCM_RIGHTS.
+/// </summary>
+class FrameExportServer
+{
+  public:
+    FrameExportServer() = default;
+    FrameExportServer(const FrameExportServer &) = delete;
+    FrameExportServer &operator=(const FrameExportServer &) = delete;
+    FrameExportServer(FrameExportServer &&) = delete;
+    FrameExportServer &operator=(FrameExportServer &&) = delete;
+    ~FrameExportServer();
+
+    void start(const std::string &socketPath);
+
+    void stop();
+
+    /// <summary>
+    /// Accept pending connections and send them the ring description along with the shared file descriptors
+    /// </summary>
+    void acceptClients(const FrameExportRingInfo &info, const std::vector<int> &sharedFds);
+
+    /// <summary>
+    /// Process release messages and drop disconnected consumers
+    /// </summary>
+    void collectReleases();
+
+    void broadcast(const FrameExportMessage &message);
+
+    bool isSlotHeld(const uint32_t &slot) const;
+
+    bool hasClients() const
+    {
+        return !m_clients.empty();
+    }
+
+  private:
+    struct Client
+    {
+        int socket = -1;
+        // bit per slot which was sent and not yet released
+        uint64_t heldSlots = 0;
+    };
+
+    int m_listenSocket = -1;
+    std::string m_socketPath;
+    std::vector<Client> m_clients;
+
+    static bool SendMessage(const int &socket, const void *data, const size_t &size, const std::vector<int> &fds);
+
+    void dropClient(const size_t &index);
+};
+} // namespace star::windowing
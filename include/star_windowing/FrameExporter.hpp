@@ -0,0 +1,106 @@
+#pragma once
+
+#include "star_windowing/FrameExportServer.hpp"
+
+#include <starlight/core/device/StarDevice.hpp>
+
+#include <vulkan/vulkan.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace star::windowing
+{
+/// <summary>
+/// Copies the final image of each frame into a ring of images whose memory is exported as opaque file descriptors, so
+/// a consumer process on the same device (such as an encoder) reads the frames without a trip through host memory. A
+/// timeline semaphore, also exported when supported, is signaled once each copy is done.
+/// </summary>
+class FrameExporter
+{
+  public:
+    FrameExporter() = default;
+    FrameExporter(const FrameExporter &) = delete;
+    FrameExporter &operator=(const FrameExporter &) = delete;
+    FrameExporter(FrameExporter &&) = delete;
+    FrameExporter &operator=(FrameExporter &&) = delete;
+    ~FrameExporter() = default;
+
+    /// <summary>
+    /// Device extensions which must be enabled for the exporter to work
+    /// </summary>
+    static std::vector<const char *> GetRequiredDeviceExtensions();
+
+    void prepRender(core::device::StarDevice &device, const vk::Extent2D &extent, const vk::Format &format,
+                    const uint8_t &numImages, const std::string &socketPath);
+
+    void cleanupRender(core::device::StarDevice &device);
+
+    /// <summary>
+    /// Service the socket and pick the slot this frame is copied into. Returns false when the frame should not be
+    /// exported, either because nobody is connected or every free slot is still in use.
+    /// </summary>
+    bool beginFrame(core::device::StarDevice &device);
+
+    /// <summary>
+    /// Record the copy of source into the slot picked by beginFrame. The source is left in sourceLayout.
+    /// </summary>
+    void recordCopy(vk::CommandBuffer &commandBuffer, const vk::Image &source, const vk::Extent2D &sourceExtent,
+                    const vk::ImageLayout &sourceLayout) const;
+
+    /// <summary>
+    /// Must be signaled to getSignalValue by the submission containing the copy
+    /// </summary>
+    vk::Semaphore getSemaphore() const
+    {
+        return m_semaphore;
+    }
+
+    uint64_t getSignalValue() const
+    {
+        return m_slots[m_currentSlot].timelineValue;
+    }
+
+    /// <summary>
+    /// Tell consumers about the frame once the copy has been submitted
+    /// </summary>
+    void endFrame();
+
+  private:
+    struct Slot
+    {
+        vk::Image image = VK_NULL_HANDLE;
+        vk::DeviceMemory memory = VK_NULL_HANDLE;
+        int memoryFd = -1;
+        // value the timeline semaphore reaches once the latest copy into this slot is done
+        uint64_t timelineValue = 0;
+        // set while the slot waits for its copy to complete before consumers are told, see m_semaphoreExported
+        bool pendingBroadcast = false;
+    };
+
+    FrameExportServer m_server;
+    FrameExportRingInfo m_ringInfo;
+    std::vector<Slot> m_slots;
+    vk::Semaphore m_semaphore = VK_NULL_HANDLE;
+    int m_semaphoreFd = -1;
+    bool m_semaphoreExported = false;
+    vk::Extent2D m_extent{};
+    uint64_t m_nextTimelineValue = 1;
+    uint32_t m_currentSlot = 0;
+
+    void createSlot(core::device::StarDevice &device, Slot &slot, const vk::Format &format,
+                    PFN_vkGetMemoryFdKHR getMemoryFd) const;
+
+    void createSemaphore(core::device::StarDevice &device);
+
+    static uint32_t FindDeviceLocalMemoryType(core::device::StarDevice &device, const uint32_t &typeBits);
+
+    /// <summary>
+    /// Send frames whose copy completed to consumers, only used when the semaphore could not be exported
+    /// </summary>
+    void broadcastCompleted(core::device::StarDevice &device);
+
+    std::vector<int> getSharedFds() const;
+};
+} // namespace star::windowing
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <chrono>
+
+namespace star::windowing
+{
+/// <summary>
+/// Holds frames to a maximum rate. Most of the wait is slept, the last stretch is spun on the clock since sleeps
+/// commonly overshoot by more than a millisecond.
+/// </summary>
+class FrameRateLimiter
+{
+  public:
+    FrameRateLimiter() = default;
+
+    /// <param name="maxFramesPerSecond">0 disables the limit</param>
+    void setMaxFramesPerSecond(const double &maxFramesPerSecond);
+
+    /// <summary>
+    /// Time before the deadline at which sleeping stops and spinning begins
+    /// </summary>
+    void setSpinThreshold(const std::chrono::microseconds &spinThreshold)
+    {
+        m_spinThreshold = spinThreshold;
+    }
+
+    bool isEnabled() const
+    {
+        return m_framePeriod.count() > 0;
+    }
+
+    /// <summary>
+    /// Block until the next frame is allowed to start
+    /// </summary>
+    void waitForNextFrame();
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    Clock::duration m_framePeriod{0};
+    std::chrono::microseconds m_spinThreshold{2000};
+    Clock::time_point m_nextFrame{};
+};
+} // namespace star::windowing
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <GLFW/glfw3.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace star::windowing
+{
+/// <summary>
+/// State of every joystick slot, polled once per frame. Laid out as structure-of-arrays so that reading one control
+/// across all devices touches a single contiguous row.
+/// </summary>
+struct GamepadSnapshot
+{
+    static constexpr size_t MaxDevices = GLFW_JOYSTICK_LAST + 1;
+    static constexpr size_t NumAxes = GLFW_GAMEPAD_AXIS_LAST + 1;
+    static constexpr size_t NumButtons = GLFW_GAMEPAD_BUTTON_LAST + 1;
+
+    /// axes[axis][device], range [-1, 1]. Triggers rest at -1 on mapped gamepads.
+    std::array<std::array<float, MaxDevices>, NumAxes> axes{};
+    /// buttons[button][device], GLFW_PRESS or GLFW_RELEASE
+    std::array<std::array<uint8_t, MaxDevices>, NumButtons> buttons{};
+    /// bit per device which is plugged in
+    uint32_t connectedMask = 0;
+    /// bit per device which has a standard gamepad mapping. Unmapped joysticks report raw axis/button order.
+    uint32_t gamepadMask = 0;
+
+    bool isConnected(const int &device) const
+    {
+        return (connectedMask >> device) & 1u;
+    }
+
+    bool isGamepad(const int &device) const
+    {
+        return (gamepadMask >> device) & 1u;
+    }
+
+    float axis(const int &device, const int &axis) const
+    {
+        return axes[axis][device];
+    }
+
+    bool isButtonPressed(const int &device, const int &button) const
+    {
+        return buttons[button][device] == GLFW_PRESS;
+    }
+
+    /// <summary>
+    /// Refresh from GLFW. Must be called from the main thread.
+    /// </summary>
+    void poll();
+};
+} // namespace star::windowing
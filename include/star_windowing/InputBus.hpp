@@ -0,0 +1,82 @@
+#pragma once
+
+#include <star_windowing/InputCodes.hpp>
+#include <star_windowing/InputRecord.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace star::windowing
+{
+/// <summary>
+/// Event bus dedicated to input. Carries InputRecords by value to plain function pointer listeners, keeping high rate
+/// input away from the subscriber tables of the device event bus. Listeners are indexed by record type, and optionally
+/// by key or mouse button code, so emitting only visits interested listeners.
+/// Not thread safe, subscribe and emit from the thread dispatching input. Listeners may subscribe and unsubscribe from
+/// inside a callback: an unsubscribed listener receives nothing further, while new subscriptions take effect once the
+/// record being emitted has been delivered.
+/// </summary>
+class InputBus
+{
+  public:
+    using Callback = void (*)(void *context, const InputRecord &record);
+
+    /// <summary>
+    /// Listen for every record of the types in the mask
+    /// </summary>
+    /// <param name="typeMask">Combination of InputRecord::TypeBit</param>
+    /// <returns>Token to pass to unsubscribe</returns>
+    uint32_t subscribe(const uint32_t &typeMask, Callback callback, void *context);
+
+    /// <summary>
+    /// Listen for key or mouse button records limited to the codes in the filter. Types in the mask which do not carry
+    /// a code of the filter's source are never delivered.
+    /// </summary>
+    uint32_t subscribe(const InputFilter &filter, const uint32_t &typeMask, Callback callback, void *context);
+
+    void unsubscribe(const uint32_t &token);
+
+    void emit(const InputRecord &record);
+
+  private:
+    struct Listener
+    {
+        Callback callback;
+        void *context;
+        uint32_t typeMask;
+        uint32_t token;
+        // unsubscribed while a record was being emitted, skipped until the entry is erased
+        bool isRemoved = false;
+    };
+
+    struct PendingSubscription
+    {
+        Listener listener;
+        bool isFiltered;
+        InputFilter filter;
+    };
+
+    std::array<std::vector<Listener>, InputRecord::NumTypes> m_typeListeners;
+    std::array<std::vector<Listener>, NumInputCodes> m_codeListeners;
+    uint32_t m_nextToken = 1;
+
+    // changes made by callbacks are held back until the outermost emit returns, so the lists are never modified while
+    // they are being iterated
+    uint32_t m_emitDepth = 0;
+    std::vector<PendingSubscription> m_pendingSubscriptions;
+    bool m_hasRemovedListeners = false;
+
+    void addListener(const Listener &listener, const bool &isFiltered, const InputFilter &filter);
+
+    void removeListener(const uint32_t &token);
+
+    void markListenerRemoved(const uint32_t &token);
+
+    void eraseRemovedListeners();
+
+    void applyPendingChanges();
+
+    void dispatch(const std::vector<Listener> &listeners, const InputRecord &record) const;
+};
+} // namespace star::windowing
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <GLFW/glfw3.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace star::windowing
+{
+enum class Input_Source : uint8_t
+{
+    key,
+    mouse_button
+};
+
+constexpr size_t NumKeyCodes = GLFW_KEY_LAST + 1;
+constexpr size_t NumMouseButtons = GLFW_MOUSE_BUTTON_LAST + 1;
+/// Size of a table holding one entry for every key and mouse button
+constexpr size_t NumInputCodes = NumKeyCodes + NumMouseButtons;
+
+constexpr bool IsValidInputCode(const Input_Source &source, const int &code)
+{
+    return code >= 0 && static_cast<size_t>(code) < (source == Input_Source::key ? NumKeyCodes : NumMouseButtons);
+}
+
+/// <summary>
+/// Position of a key or mouse button in a dense table of NumInputCodes entries
+/// </summary>
+constexpr size_t GetInputCodeIndex(const Input_Source &source, const int &code)
+{
+    return source == Input_Source::key ? static_cast<size_t>(code) : NumKeyCodes + static_cast<size_t>(code);
+}
+
+/// <summary>
+/// Inclusive range of keys or mouse buttons a listener is interested in
+/// </summary>
+struct InputFilter
+{
+    Input_Source source;
+    int first;
+    int last;
+
+    static constexpr InputFilter Key(const int &key)
+    {
+        return InputFilter{Input_Source::key, key, key};
+    }
+
+    static constexpr InputFilter KeyRange(const int &firstKey, const int &lastKey)
+    {
+        return InputFilter{Input_Source::key, firstKey, lastKey};
+    }
+
+    static constexpr InputFilter MouseButton(const int &button)
+    {
+        return InputFilter{Input_Source::mouse_button, button, button};
+    }
+
+    constexpr bool isValid() const
+    {
+        return first <= last && IsValidInputCode(source, first) && IsValidInputCode(source, last);
+    }
+};
+} // namespace star::windowing
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace star::windowing
+{
+/// <summary>
+/// Plain copy of a single GLFW input callback. Used wherever input has to be stored before it is handed to listeners.
+/// </summary>
+struct InputRecord
+{
+    enum class Type : uint8_t
+    {
+        key_press,
+        key_release,
+        mouse_button,
+        mouse_movement,
+        mouse_delta,
+        scroll
+    };
+    static constexpr size_t NumTypes = 6;
+
+    static constexpr uint32_t TypeBit(const Type &type)
+    {
+        return 1u << static_cast<uint32_t>(type);
+    }
+
+    struct KeyData
+    {
+        int key;
+        int scancode;
+        int mods;
+    };
+
+    struct MouseButtonData
+    {
+        int button;
+        int action;
+        int mods;
+    };
+
+    /// Absolute position for mouse_movement, relative motion for mouse_delta, offsets for scroll
+    struct CursorData
+    {
+        double xpos;
+        double ypos;
+    };
+
+    Type type = Type::key_press;
+    union {
+        KeyData key;
+        MouseButtonData mouseButton;
+        CursorData cursor;
+    };
+
+    static InputRecord KeyPress(int key, int scancode, int mods)
+    {
+        InputRecord record;
+        record.type = Type::key_press;
+        record.key = KeyData{key, scancode, mods};
+        return record;
+    }
+
+    static InputRecord KeyRelease(int key, int scancode, int mods)
+    {
+        InputRecord record;
+        record.type = Type::key_release;
+        record.key = KeyData{key, scancode, mods};
+        return record;
+    }
+
+    static InputRecord MouseButton(int button, int action, int mods)
+    {
+        InputRecord record;
+        record.type = Type::mouse_button;
+        record.mouseButton = MouseButtonData{button, action, mods};
+        return record;
+    }
+
+    static InputRecord MouseMovement(double xpos, double ypos)
+    {
+        InputRecord record;
+        record.type = Type::mouse_movement;
+        record.cursor = CursorData{xpos, ypos};
+        return record;
+    }
+
+    static InputRecord MouseDelta(double xdelta, double ydelta)
+    {
+        InputRecord record;
+        record.type = Type::mouse_delta;
+        record.cursor = CursorData{xdelta, ydelta};
+        return record;
+    }
+
+    static InputRecord Scroll(double xoffset, double yoffset)
+    {
+        InputRecord record;
+        record.type = Type::scroll;
+        record.cursor = CursorData{xoffset, yoffset};
+        return record;
+    }
+};
+} // namespace star::windowing
@@ -1,10 +1,18 @@
 #pragma once
 
 #include <star_common/EventBus.hpp>
+#include <star_windowing/ActionMap.hpp>
+#include <star_windowing/GamepadSnapshot.hpp>
+#include <star_windowing/InputBus.hpp>
+#include <star_windowing/InputRecord.hpp>
+#include <star_windowing/LatestValue.hpp>
+#include <star_windowing/SpscQueue.hpp>
 #include <star_windowing/WindowingContext.hpp>
 
 #include <GLFW/glfw3.h>
 
+#include <vector>
+
 namespace star::windowing
 {
 class InteractivityBus
@@ -17,7 +25,85 @@ class InteractivityBus
     static void GlfwCallbackMouseButton(GLFWwindow *window, int button, int action, int mods); 
 
     static void GlfwKeyCallback(GLFWwindow *window, int key, int scancode, int action, int mods); 
+
+    static void GlfwCallbackScroll(GLFWwindow *window, double xoffset, double yoffset);
+
+    /// <summary>
+    /// Emit all input queued by the GLFW thread. Must be called from the render thread when
+    /// running with Threading_Mode::dedicated_render_thread.
+    /// </summary>
+    static void DispatchQueuedInput();
+
+    /// <summary>
+    /// Start a new input frame, clearing per-frame state such as action press/release edges. Called once per frame
+    /// before events are pumped.
+    /// </summary>
+    static void BeginInputFrame();
+
+    /// <summary>
+    /// Dispatch input deferred during event pumping, then emit input which is accumulated over a frame rather than sent
+    /// per callback, such as captured mouse motion and scrolling, and refresh the gamepad snapshot. Called once per
+    /// frame after events have been pumped and before anything consuming input is updated.
+    /// </summary>
+    static void EndInputFrame();
+
+    /// <summary>
+    /// Poll joysticks on the GLFW event thread and hand the result to the render thread. Only needed with
+    /// Threading_Mode::dedicated_render_thread, otherwise EndInputFrame polls directly.
+    /// </summary>
+    static void PollGamepadsForRenderThread();
+
+    /// <summary>
+    /// Joystick and gamepad state as of the last EndInputFrame
+    /// </summary>
+    static const GamepadSnapshot &GetGamepadSnapshot()
+    {
+        return m_gamepads;
+    }
+
+    /// <summary>
+    /// Have key and mouse button input fed directly into an action map. The map must stay alive until it is
+    /// unregistered.
+    /// </summary>
+    static void RegisterActionMap(ActionMap &actionMap);
+
+    static void UnregisterActionMap(ActionMap &actionMap);
+
+    /// <summary>
+    /// Bus all input is delivered on
+    /// </summary>
+    static InputBus &GetInputBus()
+    {
+        return m_inputBus;
+    }
+
   private:
     static star::common::EventBus *m_deviceEventBus;
+    static bool m_forwardToDeviceBus;
+    static bool m_useCrossThreadQueue;
+    static bool m_deferDispatch;
+    static std::vector<InputRecord> m_deferredInput;
+    static SpscQueue<InputRecord, 1024> m_crossThreadQueue;
+
+    // only touched from the thread pumping GLFW events
+    static bool m_hasLastCapturedCursor;
+    static double m_lastCapturedCursorX, m_lastCapturedCursorY;
+
+    // only touched from the thread emitting events
+    static double m_accumulatedDeltaX, m_accumulatedDeltaY;
+    static double m_accumulatedScrollX, m_accumulatedScrollY;
+    static GamepadSnapshot m_gamepads;
+    static std::vector<ActionMap *> m_actionMaps;
+    static InputBus m_inputBus;
+
+    static LatestValue<GamepadSnapshot> m_crossThreadGamepads;
+
+    static void Submit(const InputRecord &record);
+
+    static void Emit(const InputRecord &record);
+
+    static void Publish(const InputRecord &record);
+
+    static void ForwardToDeviceBus(const InputRecord &record);
 };
-} // namespace star::windowing
\ No newline at end of file
+} // namespace star::windowing
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace star::windowing
+{
+/// <summary>
+/// Lock-free hand over of the most recent value from exactly one producer thread to one consumer thread. Publishing
+/// always overwrites whatever the consumer has not picked up yet, so the consumer never sees a stale value behind a
+/// newer one. Triple buffered: the producer and consumer each own a slot and swap through the third.
+/// </summary>
+/// <typeparam name="T">Trivially copyable value type</typeparam>
+template <typename T> class LatestValue
+{
+  public:
+    LatestValue() = default;
+    LatestValue(const LatestValue &) = delete;
+    LatestValue &operator=(const LatestValue &) = delete;
+
+    /// <summary>
+    /// Producer side, never blocks
+    /// </summary>
+    void publish(const T &value)
+    {
+        m_slots[m_producerSlot] = value;
+        const uint8_t previous = m_shared.exchange(m_producerSlot | NewValueBit, std::memory_order_acq_rel);
+        m_producerSlot = previous & SlotMask;
+    }
+
+    /// <summary>
+    /// Consumer side. Returns false without blocking if nothing was published since the last call.
+    /// </summary>
+    bool tryTake(T &value)
+    {
+        if (!(m_shared.load(std::memory_order_relaxed) & NewValueBit))
+        {
+            return false;
+        }
+
+        const uint8_t previous = m_shared.exchange(m_consumerSlot, std::memory_order_acq_rel);
+        m_consumerSlot = previous & SlotMask;
+        value = m_slots[m_consumerSlot];
+        return true;
+    }
+
+  private:
+    static constexpr uint8_t SlotMask = 0x3;
+    static constexpr uint8_t NewValueBit = 0x4;
+
+    std::array<T, 3> m_slots{};
+    // slot in the middle of the exchange, with NewValueBit set while it holds a value the consumer has not taken
+    std::atomic<uint8_t> m_shared{1};
+    uint8_t m_producerSlot = 0;
+    uint8_t m_consumerSlot = 2;
+};
+} // namespace star::windowing
@@ -4,6 +4,8 @@
 #include <starlight/core/device/managers/ManagerCommandBuffer.hpp>
 #include <starlight/wrappers/graphics/StarCommandBuffer.hpp>
 
+#include <vector>
+
 namespace star::windowing
 {
 class PresentationCommands
@@ -12,6 +14,10 @@ class PresentationCommands
     struct RecordDependencies
     {
         uint32_t acquiredSwapChainImageIndex;
+        // regions which changed since the previous present, the whole image is presented when empty
+        std::vector<vk::RectLayerKHR> presentRegions;
+        // false when the frame was skipped, the done semaphore is still waited on so it can be signaled again
+        bool presentImage = true;
     };
     PresentationCommands() = default;
 
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "star_windowing/WindowingContext.hpp"
+
+#include <starlight/core/device/StarDevice.hpp>
+
+#include <vulkan/vulkan.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace star::windowing
+{
+/// <summary>
+/// Converted frame as read back to host memory. Planes are tightly packed one after the other: luma, then either the
+/// interleaved chroma plane (NV12) or the U and V planes (I420).
+/// </summary>
+struct ReadbackFrame
+{
+    const void *data = nullptr;
+    size_t size = 0;
+    vk::Extent2D extent{};
+    Readback_Format format = Readback_Format::nv12;
+};
+
+/// <summary>
+/// Compute stage converting the final image to YUV 4:2:0 on the GPU, optionally at a smaller size, so only 12 bits per
+/// pixel of the output size reach host memory instead of 32 bits per pixel of the window. The final image is first
+/// blitted to a floating point image at the output size, which also does the downscale.
+/// </summary>
+class ReadbackConverter
+{
+  public:
+    ReadbackConverter() = default;
+    ReadbackConverter(const ReadbackConverter &) = delete;
+    ReadbackConverter &operator=(const ReadbackConverter &) = delete;
+    ReadbackConverter(ReadbackConverter &&) = delete;
+    ReadbackConverter &operator=(ReadbackConverter &&) = delete;
+    ~ReadbackConverter() = default;
+
+    /// <summary>
+    /// The output extent is rounded down to a multiple of 8 pixels wide and 2 pixels high
+    /// </summary>
+    void prepRender(core::device::StarDevice &device, const vk::Extent2D &outputExtent, const Readback_Format &format,
+                    const vk::Format &sourceFormat, const uint8_t &numFramesInFlight);
+
+    void cleanupRender(core::device::StarDevice &device);
+
+    /// <summary>
+    /// Record the conversion of source into the readback buffer of the frame in flight. The source is left in
+    /// sourceLayout.
+    /// </summary>
+    void recordConversion(vk::CommandBuffer &commandBuffer, const uint8_t &frameInFlightIndex,
+                          const vk::Image &source, const vk::Extent2D &sourceExtent,
+                          const vk::ImageLayout &sourceLayout) const;
+
+    /// <summary>
+    /// Contents of the readback buffer of a frame in flight. Only valid once the submission which recorded the
+    /// conversion has completed and until the frame in flight is recorded again.
+    /// </summary>
+    ReadbackFrame getFrame(core::device::StarDevice &device, const uint8_t &frameInFlightIndex) const;
+
+    vk::Extent2D getExtent() const
+    {
+        return m_extent;
+    }
+
+  private:
+    struct FrameResources
+    {
+        vk::Image image = VK_NULL_HANDLE;
+        vk::DeviceMemory imageMemory = VK_NULL_HANDLE;
+        vk::ImageView imageView = VK_NULL_HANDLE;
+        vk::Buffer buffer = VK_NULL_HANDLE;
+        vk::DeviceMemory bufferMemory = VK_NULL_HANDLE;
+        void *mapped = nullptr;
+        vk::DescriptorSet descriptorSet = VK_NULL_HANDLE;
+    };
+
+    struct PushConstants
+    {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t planeLayout = 0;
+        uint32_t encodeSrgb = 0;
+    };
+
+    static constexpr vk::Format IntermediateFormat = vk::Format::eR16G16B16A16Sfloat;
+
+    std::vector<FrameResources> m_frames;
+    vk::DescriptorSetLayout m_descriptorSetLayout = VK_NULL_HANDLE;
+    vk::DescriptorPool m_descriptorPool = VK_NULL_HANDLE;
+    vk::PipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
+    vk::Pipeline m_pipeline = VK_NULL_HANDLE;
+    vk::Extent2D m_extent{};
+    vk::DeviceSize m_readbackSize = 0;
+    Readback_Format m_format = Readback_Format::nv12;
+    bool m_encodeSrgb = false;
+    bool m_readbackCoherent = true;
+
+    void createPipeline(core::device::StarDevice &device);
+
+    void createFrameResources(core::device::StarDevice &device, FrameResources &frame);
+
+    static uint32_t FindMemoryType(const vk::PhysicalDevice &physicalDevice, const uint32_t &typeBits,
+                                   const vk::MemoryPropertyFlags &properties, bool &found);
+
+    static bool IsSrgbFormat(const vk::Format &format);
+};
+} // namespace star::windowing
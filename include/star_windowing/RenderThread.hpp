@@ -0,0 +1,61 @@
+#pragma once
+
+#include "star_windowing/WindowingContext.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace star::windowing
+{
+/// <summary>
+/// Runs the engine loop, and with it swapchain acquire, recording, submission and presentation, on a thread of its own
+/// for Threading_Mode::dedicated_render_thread. The main thread is left to pump GLFW events, so a slow frame or a
+/// blocking acquire or present never holds up input. GLFW calls which are only allowed on the main thread, such as
+/// creating and destroying the window, are handed over to it with RunOnMainThread.
+/// </summary>
+class RenderThread
+{
+  public:
+    /// <summary>
+    /// Start engineLoop on the render thread and pump events on the calling thread until it returns. Must be called
+    /// from the main thread. An exception thrown by the loop is rethrown here once the render thread has finished.
+    /// </summary>
+    static void Run(WindowingContext &winContext, std::function<void()> engineLoop);
+
+    /// <summary>
+    /// Run the task on the main thread and wait for it to finish, rethrowing anything it throws. Runs the task
+    /// directly when called from any thread other than the render thread.
+    /// </summary>
+    static void RunOnMainThread(const std::function<void()> &task);
+
+    static bool IsRenderThread()
+    {
+        return m_renderThreadId.load(std::memory_order_acquire) == std::this_thread::get_id();
+    }
+
+  private:
+    struct PendingTask
+    {
+        const std::function<void()> *task = nullptr;
+        std::exception_ptr error;
+        bool isDone = false;
+    };
+
+    static std::mutex m_mutex;
+    static std::condition_variable m_condition;
+    static std::deque<PendingTask *> m_tasks;
+    static std::atomic<std::thread::id> m_renderThreadId;
+    static std::atomic<bool> m_isRenderLoopDone;
+    // set by the main thread while it waits in GLFW, which then has to be woken with an empty event
+    static std::atomic<bool> m_isWaitingOnEvents;
+
+    static void RunPendingTasks(WindowingContext &winContext);
+
+    static void WakeMainThread();
+};
+} // namespace star::windowing
@@ -4,6 +4,8 @@
 
 #include <vulkan/vulkan.hpp>
 
+#include <optional>
+
 namespace star::windowing
 {
 class RenderingSurface
@@ -30,8 +32,17 @@ class RenderingSurface
         return m_surface;
     }
 
+    /// <summary>
+    /// Surface capabilities as of the last query. Only queried the first time, use refreshCapabilities when values
+    /// which change with the window, such as currentExtent, are needed.
+    /// </summary>
+    const vk::SurfaceCapabilities2KHR &getCapabilities(const vk::PhysicalDevice &physicalDevice);
+
+    const vk::SurfaceCapabilities2KHR &refreshCapabilities(const vk::PhysicalDevice &physicalDevice);
+
   private:
     vk::SurfaceKHR m_surface;
+    std::optional<vk::SurfaceCapabilities2KHR> m_capabilities;
 
     static vk::SurfaceKHR CreateSurface(vk::Instance instance, StarWindow &window);
 };
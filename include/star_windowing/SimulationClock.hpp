@@ -0,0 +1,69 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace star::windowing
+{
+/// <summary>
+/// Fixed timestep accumulator. Real time is measured once per frame and handed out as whole steps of a constant
+/// length, the remainder carries into the next frame. Simulation driven by this clock behaves the same regardless of
+/// frame rate, with getAlpha used to interpolate between the last two simulated states when rendering.
+/// </summary>
+class SimulationClock
+{
+  public:
+    /// <summary>
+    /// Throws if stepSeconds is not positive or maxStepsPerFrame is zero
+    /// </summary>
+    explicit SimulationClock(const double &stepSeconds = 1.0 / 120.0, const uint32_t &maxStepsPerFrame = 8);
+
+    /// <summary>
+    /// Accumulate the time since the previous call
+    /// </summary>
+    /// <returns>Number of fixed steps to simulate this frame</returns>
+    uint32_t advance();
+
+    /// <summary>
+    /// Forget accumulated time, such as after a pause. The next advance measures from this call.
+    /// </summary>
+    void reset();
+
+    /// <summary>
+    /// Change the length of a step. Throws if the step is not positive.
+    /// </summary>
+    void setStepSeconds(const double &stepSeconds);
+
+    /// <summary>
+    /// Limit how many steps a single advance may return to catch up after a slow frame. Time beyond the limit is
+    /// dropped. Throws if the limit is zero.
+    /// </summary>
+    void setMaxStepsPerFrame(const uint32_t &maxStepsPerFrame);
+
+    double getStepSeconds() const
+    {
+        return m_stepSeconds;
+    }
+
+    uint32_t getMaxStepsPerFrame() const
+    {
+        return m_maxStepsPerFrame;
+    }
+
+    /// <summary>
+    /// How far real time is between the previous and the current simulated state, in [0, 1)
+    /// </summary>
+    float getAlpha() const
+    {
+        return static_cast<float>(m_accumulatedSeconds / m_stepSeconds);
+    }
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    double m_stepSeconds;
+    uint32_t m_maxStepsPerFrame;
+    double m_accumulatedSeconds = 0.0;
+    Clock::time_point m_lastAdvance = Clock::now();
+};
+} // namespace star::windowing
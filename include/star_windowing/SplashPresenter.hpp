@@ -0,0 +1,137 @@
+#pragma once
+
+#include "star_windowing/WindowingContext.hpp"
+
+#include <starlight/core/device/StarDevice.hpp>
+
+#include <vulkan/vulkan.hpp>
+
+#include <array>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace star::windowing
+{
+/// <summary>
+/// Minimal presentation path used while the engine is still initializing. Owns a small swapchain of its own and shows
+/// a cleared, or optionally custom drawn, image as soon as the device exists, so the window is responsive long before
+/// the full SwapChainRenderer is ready. Hand the swapchain over with releaseToContext once the renderer is about to
+/// start, the real swapchain retires it when created so the window never goes blank in between. A splash swapchain
+/// already left in the context, such as by WindowingContext::presentSplashDuringInit, is retired the same way when
+/// another presenter is prepared. Everything still held is released on destruction, which must happen before the
+/// device is destroyed.
+/// </summary>
+class SplashPresenter
+{
+  public:
+    /// <summary>
+    /// Records extra commands into a splash frame. The image is in color attachment optimal layout, already cleared.
+    /// </summary>
+    using RecordSplashCallback = std::function<void(vk::CommandBuffer &commandBuffer, const vk::ImageView &imageView,
+                                                    const vk::Extent2D &extent)>;
+
+    SplashPresenter() = default;
+    explicit SplashPresenter(WindowingContext &winContext) : m_winContext(&winContext)
+    {
+    }
+    SplashPresenter(const SplashPresenter &) = delete;
+    SplashPresenter &operator=(const SplashPresenter &) = delete;
+    SplashPresenter(SplashPresenter &&other) noexcept;
+    SplashPresenter &operator=(SplashPresenter &&other);
+    ~SplashPresenter();
+
+    void prepRender(core::device::StarDevice &device);
+
+    void cleanupRender();
+
+    /// <summary>
+    /// Stop presenting and free everything except the swapchain, which is left in the windowing context for the real
+    /// swapchain to retire. Rethrows anything which failed while presenting from startPresenting.
+    /// </summary>
+    void releaseToContext();
+
+    void setClearColor(const std::array<float, 4> &clearColor)
+    {
+        m_clearColor = clearColor;
+    }
+
+    void setRecordCallback(RecordSplashCallback recordCallback)
+    {
+        m_recordCallback = std::move(recordCallback);
+    }
+
+    /// <summary>
+    /// Acquire, draw and present a single splash frame
+    /// </summary>
+    void present();
+
+    /// <summary>
+    /// Keep presenting splash frames from a thread of its own until releaseToContext, so the splash stays on screen
+    /// while initialization continues. The present queue is used from that thread, nothing else may submit to it until
+    /// presenting stops. While presenting, WindowingContext::splashPresenter points at this presenter and the real
+    /// swapchain takes over from it when created.
+    /// </summary>
+    void startPresenting();
+
+    /// <summary>
+    /// Keep the window alive and the splash on screen until isReady returns true, such as when initialization running
+    /// on worker threads has finished. Events are pumped unless the main thread is already pumping them for the render
+    /// thread, see RenderThread.
+    /// </summary>
+    void presentUntil(const std::function<bool()> &isReady);
+
+  private:
+    WindowingContext *m_winContext = nullptr;
+    // handles are kept rather than the StarDevice, which is moved once device creation returns
+    vk::Device m_device = VK_NULL_HANDLE;
+    vk::PhysicalDevice m_physicalDevice = VK_NULL_HANDLE;
+    vk::Queue m_presentQueue = VK_NULL_HANDLE;
+    std::vector<uint32_t> m_queueFamilyIndices;
+    vk::SwapchainKHR m_swapChain = VK_NULL_HANDLE;
+    vk::Format m_format = vk::Format::eUndefined;
+    vk::Extent2D m_extent{};
+    std::vector<vk::Image> m_images;
+    std::vector<vk::ImageView> m_imageViews;
+    vk::CommandPool m_commandPool = VK_NULL_HANDLE;
+    vk::CommandBuffer m_commandBuffer = VK_NULL_HANDLE;
+    // waited on for each acquire and submission in turn, every splash frame completes before the next one starts
+    vk::Fence m_fence = VK_NULL_HANDLE;
+    std::array<float, 4> m_clearColor{0.0f, 0.0f, 0.0f, 1.0f};
+    RecordSplashCallback m_recordCallback;
+
+    std::thread m_presentThread;
+    std::mutex m_presentMutex;
+    std::condition_variable m_presentCondition;
+    bool m_isPresenting = false;
+    std::exception_ptr m_presentError;
+
+    void createSwapChain(const vk::SwapchainKHR &oldSwapChain);
+
+    /// <summary>
+    /// Replace the swapchain with one matching the current surface, the current one is retired by the new one
+    /// </summary>
+    void recreateSwapChain();
+
+    /// <summary>
+    /// Present a frame unless the window is minimized
+    /// </summary>
+    void presentIfVisible();
+
+    /// <summary>
+    /// Stop the thread started by startPresenting, if any. Failures while presenting are kept in m_presentError.
+    /// </summary>
+    void stopPresenting();
+
+    void waitForFence(const char *errorMessage);
+
+    void destroyImageViews();
+
+    void release();
+
+    void recordFrame(vk::CommandBuffer &commandBuffer, const uint32_t &imageIndex);
+};
+} // namespace star::windowing
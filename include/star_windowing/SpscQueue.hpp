@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace star::windowing
+{
+/// <summary>
+/// Bounded lock-free queue for exactly one producer thread and one consumer thread.
+/// </summary>
+/// <typeparam name="T">Trivially copyable item type</typeparam>
+/// <typeparam name="Capacity">Number of slots, must be a power of two</typeparam>
+template <typename T, size_t Capacity> class SpscQueue
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+  public:
+    SpscQueue() = default;
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    /// <summary>
+    /// Producer side. Returns false without blocking if the queue is full.
+    /// </summary>
+    bool tryPush(const T &item)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) == Capacity)
+        {
+            return false;
+        }
+
+        m_items[head & (Capacity - 1)] = item;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// <summary>
+    /// Consumer side. Returns false without blocking if the queue is empty.
+    /// </summary>
+    bool tryPop(T &item)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        item = m_items[tail & (Capacity - 1)];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const
+    {
+        return m_tail.load(std::memory_order_acquire) == m_head.load(std::memory_order_acquire);
+    }
+
+  private:
+    // producer and consumer indices live on separate cache lines so the two threads do not false share
+    alignas(64) std::atomic<size_t> m_head{0};
+    alignas(64) std::atomic<size_t> m_tail{0};
+    std::array<T, Capacity> m_items{};
+};
+} // namespace star::windowing
@@ -3,11 +3,24 @@
 #include <GLFW/glfw3.h>
 #include <vulkan/vulkan.hpp>
 
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
+#include <utility>
 
 namespace star::windowing
 {
+enum class Display_Mode
+{
+    windowed,
+    borderless_fullscreen, // covers the monitor using its current video mode, no mode switch
+    exclusive_fullscreen   // takes over the monitor and switches it to the closest matching video mode
+};
+
 class StarWindow
 {
   public:
@@ -19,63 +32,221 @@ class StarWindow
         Builder &setWidth(const int &nWidth);
         Builder &setHeight(const int &nHeight);
         Builder &setTitle(const std::string &nTitle);
+        Builder &setResizable(const bool &nResizable);
+        Builder &setDisplayMode(const Display_Mode &nDisplayMode);
+        /// <summary>
+        /// Monitor used for fullscreen modes, as an index into the connected monitors. 0 is always the primary monitor.
+        /// </summary>
+        Builder &setMonitor(const int &nMonitorIndex);
+        /// <summary>
+        /// Preferred refresh rate for exclusive fullscreen, 0 picks the highest one available at the requested size
+        /// </summary>
+        Builder &setRefreshRate(const int &nRefreshRate);
         std::unique_ptr<StarWindow> buildUnique();
         StarWindow build();
 
       private:
         int width = 0, height = 0;
         std::string title = std::string();
+        bool resizable = true;
+        Display_Mode displayMode = Display_Mode::windowed;
+        int monitorIndex = 0;
+        int refreshRate = 0;
+
+        friend class StarWindow;
     };
     StarWindow() = default;
+    StarWindow(const StarWindow &) = delete;
+    StarWindow &operator=(const StarWindow &) = delete;
+    StarWindow(StarWindow &&other) noexcept;
+    StarWindow &operator=(StarWindow &&other) noexcept;
+    ~StarWindow() = default;
 
     void cleanupRender();
 
+    /// <summary>
+    /// Initialize GLFW if it is not already. Must be called from the main thread.
+    /// </summary>
+    static void InitGLFW();
+
     vk::SurfaceKHR createWindowSurface(const vk::Instance &instance);
 
     void resetWindowResizedFlag()
     {
-        this->frambufferResized = false;
+        this->frambufferResized.store(false, std::memory_order_release);
     }
     bool shouldClose() const
     {
-        return glfwWindowShouldClose(this->window);
+        return m_closeRequested.load(std::memory_order_acquire) || glfwWindowShouldClose(this->window);
+    }
+
+    /// <summary>
+    /// Ask for the window to close. Safe to call from any thread, wakes the thread pumping GLFW events.
+    /// </summary>
+    void requestClose();
+
+    /// <summary>
+    /// Hide and lock the cursor to the window so that it reports unbounded relative motion. Raw (unaccelerated) motion
+    /// is enabled as well when the platform supports it. Handed to the main thread when called from the render thread.
+    /// </summary>
+    void setCursorCaptured(const bool &captured);
+
+    bool isCursorCaptured() const
+    {
+        return m_cursorCaptured.load(std::memory_order_acquire);
     }
+    /// <summary>
+    /// Size of the window in screen coordinates. Served from a cache kept current by GLFW callbacks, safe to call from
+    /// any thread. The same applies to the other window metrics below.
+    /// </summary>
     vk::Extent2D getWindowSize() const
     {
-        int width = 0;
-        int height = 0;
-        glfwGetWindowSize(window, &width, &height);
-
-        return {static_cast<uint32_t>(width), static_cast<uint32_t>(height)};
+        const auto packed = UnpackPair(m_windowSize.load(std::memory_order_acquire));
+        return {packed.first, packed.second};
     }
+    /// <summary>
+    /// Size of the framebuffer in pixels
+    /// </summary>
     vk::Extent2D getWindowFramebufferSize() const
     {
-        int width = 0;
-        int height = 0;
-        glfwGetFramebufferSize(window, &width, &height);
-
-        return {static_cast<uint32_t>(width), static_cast<uint32_t>(height)};
+        const auto packed = UnpackPair(m_framebufferSize.load(std::memory_order_acquire));
+        return {packed.first, packed.second};
+    }
+    /// <summary>
+    /// Ratio between the current DPI and the platform's default DPI
+    /// </summary>
+    std::pair<float, float> getContentScale() const
+    {
+        const auto packed = UnpackPair(m_contentScale.load(std::memory_order_acquire));
+        return {std::bit_cast<float>(packed.first), std::bit_cast<float>(packed.second)};
+    }
+    /// <summary>
+    /// Position of the upper-left corner of the content area in screen coordinates
+    /// </summary>
+    vk::Offset2D getWindowPosition() const
+    {
+        const auto packed = UnpackPair(m_position.load(std::memory_order_acquire));
+        return {static_cast<int32_t>(packed.first), static_cast<int32_t>(packed.second)};
+    }
+    bool isFocused() const
+    {
+        return m_focused.load(std::memory_order_acquire);
     }
     bool wasWindowResized() const
     {
-        return this->frambufferResized;
+        return this->frambufferResized.load(std::memory_order_acquire);
+    }
+
+    /// <summary>
+    /// Time since the framebuffer size last changed. Used to wait for a resize to settle before rebuilding.
+    /// </summary>
+    double getSecondsSinceLastResize() const
+    {
+        const auto lastResize = std::chrono::steady_clock::duration(m_lastResizeTicks.load(std::memory_order_acquire));
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch() - lastResize).count();
+    }
+
+    /// <summary>
+    /// Called when the window contents need to be redrawn while a resize is in progress. Some platforms block the
+    /// event loop for the length of a resize drag, rendering a frame from here keeps the contents live.
+    /// </summary>
+    void setRefreshCallback(std::function<void()> callback)
+    {
+        m_refreshCallback = std::move(callback);
+    }
+
+    /// <summary>
+    /// True while the refresh callback is running. Events must not be pumped from inside it.
+    /// </summary>
+    bool isRefreshing() const
+    {
+        return m_refreshing;
     }
     GLFWwindow *getGLFWWindow() const
     {
         return this->window;
     }
+    Display_Mode getDisplayMode() const
+    {
+        return m_displayMode;
+    }
+    /// <summary>
+    /// Refresh rate of the video mode the window was created with in Hz, 0 when unknown such as for windowed mode
+    /// </summary>
+    int getRefreshRate() const
+    {
+        return m_refreshRate;
+    }
 
   protected:
-    StarWindow(const int &width, const int &height, const std::string &title);
+    explicit StarWindow(const Builder &settings);
 
     void initWindowInfo();
 
-    static GLFWwindow *CreateGLFWWindow(const int &width, const int &height, const std::string &title);
+    /// <summary>
+    /// Fill the metric cache directly from GLFW, callbacks keep it current afterwards
+    /// </summary>
+    void refreshCachedMetrics();
+
+    static GLFWwindow *CreateGLFWWindow(const Builder &settings, int &selectedRefreshRate);
+
+    static GLFWmonitor *SelectMonitor(const int &monitorIndex);
+
+    /// <summary>
+    /// Video mode of the monitor closest to the requested size and refresh rate, the current mode if no size matches
+    /// </summary>
+    static const GLFWvidmode *SelectVideoMode(GLFWmonitor *monitor, const int &width, const int &height,
+                                              const int &refreshRate);
+
+    /// <summary>
+    /// Ask an X11 compositor to leave the window alone so presented images go straight to the display. Does nothing
+    /// unless built with STAR_WINDOWING_X11_BYPASS_COMPOSITOR or when not running on X11.
+    /// </summary>
+    static void RequestCompositorBypass(GLFWwindow *window);
 
     static void DestroyWindow(GLFWwindow *window);
 
+    static void GlfwCallbackFramebufferSize(GLFWwindow *window, int width, int height);
+
+    static void GlfwCallbackWindowClose(GLFWwindow *window);
+
+    static void GlfwCallbackWindowRefresh(GLFWwindow *window);
+
+    static void GlfwCallbackWindowSize(GLFWwindow *window, int width, int height);
+
+    static void GlfwCallbackContentScale(GLFWwindow *window, float xscale, float yscale);
+
+    static void GlfwCallbackWindowPosition(GLFWwindow *window, int xpos, int ypos);
+
+    static void GlfwCallbackWindowFocus(GLFWwindow *window, int focused);
+
   private:
-    bool frambufferResized = false;
+    // only touched from the main thread
+    static bool m_isGLFWInitialized;
+
+    // pairs of values are packed into one word so readers never see half of an update
+    static constexpr uint64_t PackPair(const uint32_t &first, const uint32_t &second)
+    {
+        return (static_cast<uint64_t>(first) << 32) | second;
+    }
+    static constexpr std::pair<uint32_t, uint32_t> UnpackPair(const uint64_t &packed)
+    {
+        return {static_cast<uint32_t>(packed >> 32), static_cast<uint32_t>(packed)};
+    }
+
+    std::atomic<uint64_t> m_windowSize = 0;
+    std::atomic<uint64_t> m_framebufferSize = 0;
+    std::atomic<uint64_t> m_contentScale = PackPair(std::bit_cast<uint32_t>(1.0f), std::bit_cast<uint32_t>(1.0f));
+    std::atomic<uint64_t> m_position = 0;
+    std::atomic<bool> m_focused = false;
+    std::atomic<bool> frambufferResized = false;
+    std::atomic<bool> m_closeRequested = false;
+    std::atomic<bool> m_cursorCaptured = false;
+    std::atomic<std::chrono::steady_clock::rep> m_lastResizeTicks = 0;
+    std::function<void()> m_refreshCallback;
+    bool m_refreshing = false;
+    Display_Mode m_displayMode = Display_Mode::windowed;
+    int m_refreshRate = 0;
     GLFWwindow *window = nullptr;
 
     friend class Builder;
@@ -1,12 +1,17 @@
 #pragma once
 
+#include "star_windowing/DamageTracker.hpp"
+#include "star_windowing/FrameExporter.hpp"
 #include "star_windowing/PresentationCommands.hpp"
+#include "star_windowing/ReadbackConverter.hpp"
 #include "star_windowing/StarWindow.hpp"
 #include "star_windowing/WindowingContext.hpp"
 
 #include <starlight/core/renderer/DefaultRenderer.hpp>
 #include <vulkan/vulkan.hpp>
 
+#include <algorithm>
+#include <functional>
 #include <memory>
 
 namespace star::windowing
@@ -37,6 +42,78 @@ class SwapChainRenderer : public star::core::renderer::DefaultRenderer
 
     virtual void frameUpdate(common::IDeviceContext &context) override;
 
+    /// <summary>
+    /// Receive each frame converted by the readback stage, see WindowingContext::readbackFormat. Called on the render
+    /// thread right before the same frame in flight is submitted again, the data is overwritten once it returns.
+    /// </summary>
+    void setReadbackCallback(std::function<void(const ReadbackFrame &)> callback)
+    {
+        m_readbackCallback = std::move(callback);
+    }
+
+    /// <summary>
+    /// Report a region of the window, in framebuffer pixels, which needs to be redrawn. Only used with
+    /// WindowingContext::damageTracking, in which case regions never reported keep their previous contents and frames
+    /// without any damage are not presented.
+    /// </summary>
+    void addDamage(const vk::Rect2D &region)
+    {
+        m_damage.addDamage(region);
+        publishPendingDamage();
+    }
+
+    void damageAll()
+    {
+        m_damage.damageAll();
+        publishPendingDamage();
+    }
+
+    /// <summary>
+    /// Re-record the cached command buffers before their next use, see WindowingContext::cacheStaticCommandBuffers.
+    /// Changes made through this renderer, such as a new final compute pass or swapchain, already
+    /// invalidate. Objects are handed over once at construction, so anything changed on them afterwards, such as a
+    /// replaced pipeline or camera buffer binding, needs this call. Changes to the contents of bound buffers do not.
+    /// </summary>
+    void invalidateRecordedCommands()
+    {
+        std::fill(m_cachedCommandBuffersValid.begin(), m_cachedCommandBuffersValid.end(), false);
+    }
+
+    /// <summary>
+    /// Swapchain image handed to the final compute pass. It is in eGeneral layout while the pass records and its
+    /// previous contents are undefined, so every pixel must be written.
+    /// </summary>
+    struct ComputeTarget
+    {
+        vk::Image image = VK_NULL_HANDLE;
+        vk::ImageView view = VK_NULL_HANDLE;
+        vk::Extent2D extent{};
+        vk::Format format = vk::Format::eUndefined;
+        uint8_t frameInFlightIndex = 0;
+    };
+
+    /// <summary>
+    /// Replace the main raster pass with a compute pass writing straight to the swapchain image, for full screen
+    /// post processing without an intermediate target. Only used when the swapchain could be created with storage
+    /// usage, see WindowingContext::computeToSwapChain, otherwise objects are drawn as usual. Registering or removing
+    /// the pass has the swapchain rebuilt with a matching format before the next frame.
+    /// </summary>
+    void setFinalComputePass(std::function<void(vk::CommandBuffer &, const ComputeTarget &)> recordPass)
+    {
+        m_finalComputePass = std::move(recordPass);
+        if (m_winContext != nullptr)
+        {
+            m_winContext->hasFinalComputePass = static_cast<bool>(m_finalComputePass);
+        }
+        invalidateRecordedCommands();
+        publishPendingDamage();
+    }
+
+    bool isComputingToSwapChain() const
+    {
+        return m_finalComputePass && m_winContext != nullptr && m_winContext->swapChainInfo.storageUsage;
+    }
+
     std::vector<Handle> &getDoneSemaphores()
     {
         return imageAvailableSemaphores;
@@ -52,21 +129,49 @@ class SwapChainRenderer : public star::core::renderer::DefaultRenderer
     vk::SwapchainKHR m_swapChain;
     PresentationCommands::RecordDependencies m_presentationSharedDeps;
     PresentationCommands m_presentationCommands;
+    // only created when WindowingContext::frameExportSocketPath is set
+    std::unique_ptr<FrameExporter> m_frameExporter;
+    bool m_exportThisFrame = false;
+    // only created when WindowingContext::readbackFormat is set
+    std::unique_ptr<ReadbackConverter> m_readbackConverter;
+    std::function<void(const ReadbackFrame &)> m_readbackCallback;
+    DamageTracker m_damage;
+    std::function<void(vk::CommandBuffer &, const ComputeTarget &)> m_finalComputePass;
+    // swapchain format the frame exporter and readback converter were created for
+    vk::Format m_copyStageFormat = vk::Format::eUndefined;
+    // one command buffer per swapchain image and frame in flight, indexed image * numFramesInFlight + frame
+    vk::CommandPool m_cachedCommandPool = VK_NULL_HANDLE;
+    std::vector<vk::CommandBuffer> m_cachedCommandBuffers;
+    std::vector<bool> m_cachedCommandBuffersValid;
+    // per frame in flight, sequence number of the frame its readback buffer holds which was not delivered yet, 0 for
+    // none. Frames left idle by a lower active frame count come back holding older frames, which are dropped
+    std::vector<uint64_t> m_pendingReadbacks;
+    uint64_t m_readbackSequence = 0, m_lastDeliveredReadback = 0;
 
     // tracker for which frame is being processed of the available permitted frames
     uint8_t previousFrame = 0, numFramesInFlight = 0;
+    // generation of the swapchain whose images are currently being rendered to
+    uint32_t m_swapChainGeneration = 0;
 
     bool frameBufferResized =
         false; // explicit declaration of resize, used if driver does not trigger VK_ERROR_OUT_OF_DATE
 
     // Sync obj storage
     std::vector<Handle> imageAvailableSemaphores;
+    // the same semaphores as taken from the window's SyncObjectPool, handed back on cleanup
+    std::vector<SyncObjectPool::Semaphore> m_pooledSemaphores;
+    // signaled instead of the per image semaphores by frames which were skipped, those could still be pending for the
+    // image last presented
+    SyncObjectPool::Semaphore m_skippedFrameSemaphore;
     std::vector<Handle> graphicsDoneSemaphoresExternalUse; /// These are guaranteed to match with the current frame in
                                                            /// flight for other command buffers to reference
 
     virtual star::core::device::manager::ManagerCommandBuffer::Request getCommandBufferRequest() override;
 
-    vk::SurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<vk::SurfaceFormatKHR> &availableFormats) const;
+    /// <summary>
+    /// Whether frames are replayed from the cached command buffers, read once when preparing
+    /// </summary>
+    bool usesCachedCommandBuffers() const;
 
     bool doesSwapChainSupportTransferOperations(core::device::DeviceContext &context) const;
 
@@ -88,17 +193,49 @@ class SwapChainRenderer : public star::core::renderer::DefaultRenderer
                                      const uint64_t &frameIndex) override;
 
     /// <summary>
-    /// If the swapchain is no longer compatible, it must be recreated.
+    /// Switch over to the swapchain published in the windowing context after it was recreated, such as on resize
     /// </summary>
-    virtual void recreateSwapChain();
+    virtual void recreateSwapChain(core::device::DeviceContext &context);
+
+    void prepareRenderingContext(core::device::DeviceContext &context);
 
     /// <summary>
-    /// Create semaphores that are going to be used to sync rendering and presentation queues
+    /// Hand the swapchain image to the final compute pass and leave it ready for presentation
     /// </summary>
-    static std::vector<Handle> CreateSemaphores(core::device::DeviceContext &context, const uint8_t &numToCreate,
-                                                const bool &isTimeline);
+    void recordFinalComputePass(vk::CommandBuffer &commandBuffer, const common::FrameTracker &frameTracker);
 
-    void prepareRenderingContext(core::device::DeviceContext &context);
+    /// <summary>
+    /// Clear the regions of the current image which are about to be redrawn, leaving everything else untouched
+    /// </summary>
+    void recordDamageClears(vk::CommandBuffer &commandBuffer, const common::FrameTracker &frameTracker);
+
+    /// <summary>
+    /// Tell the swapchain controller whether the next frame has anything to present, see
+    /// WindowingContext::hasPendingDamage. The final compute pass rewrites every frame and is not tracked.
+    /// </summary>
+    void publishPendingDamage()
+    {
+        if (m_winContext != nullptr)
+        {
+            m_winContext->hasPendingDamage = isComputingToSwapChain() || m_damage.hasFrameDamage();
+        }
+    }
+
+    /// <summary>
+    /// Frame export and readback, both created for the current swapchain format
+    /// </summary>
+    void prepCopyStages(core::device::DeviceContext &context);
+
+    void cleanupCopyStages(core::device::DeviceContext &context);
+
+    void prepCachedCommandBuffers(core::device::DeviceContext &context);
+
+    void cleanupCachedCommandBuffers(core::device::DeviceContext &context);
+
+    /// <summary>
+    /// Cached command buffer for the current swapchain image and frame in flight, recorded first if invalidated
+    /// </summary>
+    vk::CommandBuffer &getCachedCommandBuffer(const common::FrameTracker &frameTracker, const uint64_t &frameIndex);
 
     void addSemaphoresToRenderingContext(core::device::DeviceContext &context);
 
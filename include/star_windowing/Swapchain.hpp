@@ -1,5 +1,6 @@
 #pragma once
 
+#include "star_windowing/SyncObjectPool.hpp"
 #include "star_windowing/WindowingContext.hpp"
 #include <star_common/EventBus.hpp>
 #include <star_common/FrameTracker.hpp>
@@ -24,26 +25,61 @@ class SwapChain
 
     void cleanupRender(core::device::StarDevice &device);
 
+    /// <summary>
+    /// Replace the swapchain with one matching the current surface, such as after a resize. The old swapchain is handed
+    /// to the new one so presentation can transition without a gap.
+    /// </summary>
+    void recreate(core::device::StarDevice &device, common::FrameTracker &deviceFrameTracker);
+
     uint8_t getNumImagesGuaranteedInSwapchain(core::device::StarDevice &device) const;
 
     vk::ResultValue<uint32_t> acquireNextSwapChainImage(core::device::StarDevice &device,
                                                         const common::FrameTracker &frameTracker) noexcept;
 
+    /// <summary>
+    /// Go through the current frame without acquiring an image, nothing is drawn or presented for it
+    /// </summary>
+    void skipNextSwapChainImage(core::device::StarDevice &device, const common::FrameTracker &frameTracker);
+
+    /// <summary>
+    /// Whether the swapchain was created for a different final compute pass setup than the current one, see
+    /// WindowingContext::computeToSwapChain
+    /// </summary>
+    bool isStorageUsageOutdated() const
+    {
+        return m_winContext != nullptr && m_swapChain != VK_NULL_HANDLE && wantsStorageUsage() != m_storageRequested;
+    }
+
     vk::SwapchainKHR &getVulkanSwapchain()
     {
         return m_swapChain;
     }
 
   private:
-    std::vector<Handle> m_imageAcquireSemaphores, m_inFlightFences, m_imagesInFlight;
+    // taken from the window's SyncObjectPool and handed back on cleanup
+    std::vector<SyncObjectPool::Semaphore> m_imageAcquireSemaphores;
+    std::vector<SyncObjectPool::Fence> m_inFlightFences;
+    std::vector<Handle> m_imagesInFlight;
+    size_t m_numImages = 0;
     star::core::MappedHandleContainer<vk::Fence> m_fenceStorage =
         star::core::MappedHandleContainer<vk::Fence>{common::special_types::FenceTypeName};
-    std::vector<vk::Fence *> m_inFlightFencesRaw;
-    std::vector<vk::Semaphore *> m_imageAcquireSemaphoresRaw;
     vk::SwapchainKHR m_swapChain{VK_NULL_HANDLE};
+    vk::SurfaceFormatKHR m_surfaceFormat{};
+    vk::Extent2D m_extent{};
+    bool m_storageUsage = false;
+    // storage usage was asked for when the swapchain was created, it might still have been unsupported
+    bool m_storageRequested = false;
     WindowingContext *m_winContext = nullptr;
 
-    vk::SwapchainKHR createSwapchain(core::device::StarDevice &device, common::FrameTracker &deviceFrameTracker);
+    vk::SwapchainKHR createSwapchain(core::device::StarDevice &device, common::FrameTracker &deviceFrameTracker,
+                                     vk::SwapchainKHR oldSwapChain = VK_NULL_HANDLE);
+
+    void publishSwapChain();
+
+    bool wantsStorageUsage() const
+    {
+        return m_winContext->computeToSwapChain && m_winContext->hasFinalComputePass;
+    }
 
     void waitForPreviousFrameInFlightToBeDone(core::device::StarDevice &device, const uint32_t &imageIndex);
 
@@ -53,12 +89,19 @@ class SwapChain
                                      vk::SurfaceFormatKHR &selectedSurfaceFormat,
                                      vk::PresentModeKHR &selectedPresentMode,
                                      vk::SurfaceTransformFlagBitsKHR &selectedTransform, uint8_t &selectedNumImages,
-                                     bool &doesSupportTransfer) const;
+                                     bool &doesSupportTransfer, bool &doesSupportStorage) const;
 
     vk::Extent2D chooseSwapChainExtent(const vk::SurfaceCapabilities2KHR &caps) const;
 
     vk::SurfaceFormatKHR chooseSurfaceFormat(const core::SwapChainSupportDetails &supportDetails) const;
 
+    /// <summary>
+    /// Pick a UNORM format which compute shaders can write to, returns false when the surface offers none
+    /// </summary>
+    bool chooseStorageSurfaceFormat(core::device::StarDevice &device,
+                                    const core::SwapChainSupportDetails &supportDetails,
+                                    const vk::SurfaceCapabilities2KHR &caps, vk::SurfaceFormatKHR &selected) const;
+
     uint8_t chooseNumOfImages(const vk::SurfaceCapabilities2KHR &caps) const;
 
     vk::PresentModeKHR choosePresentationMode(const core::SwapChainSupportDetails &supportDetails) const;
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <star_common/EventBus.hpp>
+#include <star_common/Handle.hpp>
+#include <starlight/core/device/StarDevice.hpp>
+
+#include <vulkan/vulkan.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace star::windowing
+{
+/// <summary>
+/// Fences and binary semaphores used to pace the frames of one window. Objects are requested from the device managers
+/// in batches and go back to the pool once their last use has retired, so rebuilding the per frame sync objects
+/// reuses what the window already has instead of creating a new set each time.
+/// </summary>
+class SyncObjectPool
+{
+  public:
+    struct Fence
+    {
+        Handle handle;
+        vk::Fence *fence = nullptr;
+    };
+
+    struct Semaphore
+    {
+        Handle handle;
+        vk::Semaphore *semaphore = nullptr;
+    };
+
+    /// <summary>
+    /// Fences are handed out signaled
+    /// </summary>
+    std::vector<Fence> acquireFences(core::device::StarDevice &device, common::EventBus &eventBus,
+                                     const size_t &numFences);
+
+    std::vector<Semaphore> acquireSemaphores(core::device::StarDevice &device, common::EventBus &eventBus,
+                                             const size_t &numSemaphores);
+
+    /// <summary>
+    /// The fence goes back to the pool once it is signaled, meaning the last submission using it has completed
+    /// </summary>
+    void releaseFence(const Fence &fence);
+
+    /// <summary>
+    /// Binary semaphores cannot be queried, so the semaphore goes back to the pool once retiredBy is signaled. Without
+    /// a fence, the caller guarantees no submitted work still uses the semaphore.
+    /// </summary>
+    void releaseSemaphore(const Semaphore &semaphore, const vk::Fence &retiredBy = VK_NULL_HANDLE);
+
+    size_t getNumCreatedFences() const
+    {
+        return m_numCreatedFences;
+    }
+
+    size_t getNumCreatedSemaphores() const
+    {
+        return m_numCreatedSemaphores;
+    }
+
+  private:
+    static constexpr size_t BatchSize = 4;
+
+    struct RetiringSemaphore
+    {
+        Semaphore semaphore;
+        vk::Fence retiredBy = VK_NULL_HANDLE;
+    };
+
+    std::vector<Fence> m_freeFences, m_retiringFences;
+    std::vector<Semaphore> m_freeSemaphores;
+    std::vector<RetiringSemaphore> m_retiringSemaphores;
+    size_t m_numCreatedFences = 0, m_numCreatedSemaphores = 0;
+
+    void collectRetired(core::device::StarDevice &device);
+
+    void createFences(common::EventBus &eventBus, const size_t &numFences);
+
+    void createSemaphores(common::EventBus &eventBus, const size_t &numSemaphores);
+
+    /// <summary>
+    /// Round a shortfall up to whole batches
+    /// </summary>
+    static size_t GetBatchedCount(const size_t &shortfall);
+};
+} // namespace star::windowing
@@ -2,20 +2,151 @@
 
 #include "star_windowing/RenderingSurface.hpp"
 #include "star_windowing/StarWindow.hpp"
+#include "star_windowing/SyncObjectPool.hpp"
 
+#include <array>
+#include <chrono>
+#include <functional>
+#include <string>
 #include <vector>
 namespace star::windowing
 {
+class SplashPresenter;
+
+enum class Threading_Mode
+{
+    single_thread,          // GLFW events are pumped inline with rendering
+    dedicated_render_thread // the main thread only pumps GLFW events, the engine loop runs on RenderThread
+};
+
+enum class Input_Dispatch_Mode
+{
+    immediate, // listeners run from inside the GLFW callbacks while events are being pumped
+    deferred   // input is queued while pumping and dispatched in one batch at the end of the input phase
+};
+
+enum class Event_Wait_Mode
+{
+    poll,         // process pending events and continue immediately
+    wait_timeout, // sleep until an event arrives or eventWaitTimeoutSeconds pass
+    wait          // sleep until an event arrives, for applications which only redraw in response to input
+};
+
+enum class Readback_Format
+{
+    disabled,
+    nv12, // luma plane followed by one plane of interleaved U and V
+    i420  // luma plane followed by separate U and V planes
+};
+
+/// <summary>
+/// How long each phase of bringing up the window and device took. Phases which ran in parallel overlap, so they do not
+/// add up to timeToFirstFrameSubmit.
+/// </summary>
+struct StartupTimings
+{
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    std::chrono::steady_clock::time_point start{};
+    Milliseconds glfwInit{0}, instanceCreation{0}, windowCreation{0}, surfaceCreation{0}, deviceCreation{0};
+    // from start until the first frame was handed to the GPU, zero until then
+    Milliseconds timeToFirstFrameSubmit{0};
+};
+
 struct WindowingContext
 {
     struct CurrentFrameSyncInfo
     {
         vk::Semaphore *swapChainAcquireSemaphore = nullptr;
         vk::Fence *imageAvailableFence = nullptr;
+        // false when no swapchain image could be acquired for this frame, such as while minimized or in the middle of
+        // a resize. Nothing is drawn or presented for the frame then
+        bool imageAcquired = false;
+    };
+
+    struct CurrentSwapChainInfo
+    {
+        vk::SwapchainKHR swapChain = VK_NULL_HANDLE;
+        // incremented each time the swapchain is created, anything holding swapchain images refreshes on change
+        uint32_t generation = 0;
+        // format the swapchain images were created with, the renderer's color attachments use the same one
+        vk::SurfaceFormatKHR surfaceFormat{};
+        // size of the swapchain images, lags behind the framebuffer size while a resize settles
+        vk::Extent2D extent{};
+        // images can be written from compute shaders, only with computeToSwapChain
+        bool storageUsage = false;
     };
 
     RenderingSurface surface;
     StarWindow window;
     CurrentFrameSyncInfo syncInfo;
+    // fences and semaphores of this window's frames, shared by the swapchain and its renderer
+    SyncObjectPool syncObjects;
+    CurrentSwapChainInfo swapChainInfo;
+    // with damageTracking, whether anything was reported since the previous frame. Kept up to date by the renderer,
+    // while nothing changed frames are skipped without acquiring or presenting an image
+    bool hasPendingDamage = true;
+    // set by the renderer while a final compute pass is registered, the swapchain follows it, see computeToSwapChain
+    bool hasFinalComputePass = false;
+    // swapchain left behind by the splash presenter, passed as the old swapchain when the real one is created
+    vk::SwapchainKHR splashSwapChain = VK_NULL_HANDLE;
+    // splash presenter still presenting from its own thread, the real swapchain stops it before taking over
+    SplashPresenter *splashPresenter = nullptr;
+    StartupTimings startupTimings;
+    // used when the window is created, the swapchain follows the size of the selected video mode
+    Display_Mode displayMode = Display_Mode::windowed;
+    int displayMonitorIndex = 0;
+    int displayRefreshRate = 0;
+    Threading_Mode threadingMode = Threading_Mode::single_thread;
+    Input_Dispatch_Mode inputDispatchMode = Input_Dispatch_Mode::immediate;
+    // how the main loop pumps events with Threading_Mode::single_thread
+    Event_Wait_Mode eventWaitMode = Event_Wait_Mode::poll;
+    double eventWaitTimeoutSeconds = 1.0 / 60.0;
+    // with Threading_Mode::single_thread, renders one frame of the engine loop. Some platforms stop returning from
+    // event pumping for as long as the window is being resized, this is then called from the window refresh callback
+    // to keep the contents live. The render thread keeps drawing by itself, so it is not used with
+    // Threading_Mode::dedicated_render_thread. See EngineMainLoopPolicy::setRefreshFrame
+    std::function<void()> refreshFrame;
+    // frames in flight cycled through, at most the count passed to EngineInitPolicy::init which every per frame
+    // resource is allocated for, 0 for all of them. Can be changed while running, 1 for the lowest latency or more for
+    // throughput, and takes effect the next time the frame in flight index starts over
+    uint8_t activeFramesInFlight = 0;
+    // upper bound on frames started per second, 0 for no limit
+    double maxFramesPerSecond = 0.0;
+    // while resizing, keep presenting at the old size until the framebuffer size stops changing for this long...
+    double resizeSettleSeconds = 0.1;
+    // ...or this many frames have been presented at the old size
+    uint32_t resizeMaxDeferredFrames = 30;
+    // clear and present the window as soon as the device exists instead of waiting for the renderer to be ready. Adds
+    // a short lived swapchain to startup which keeps presenting until the real swapchain is created, see
+    // SplashPresenter::startPresenting. The engine must not submit to the present queue before then
+    bool presentSplashDuringInit = true;
+    std::array<float, 4> splashClearColor{0.0f, 0.0f, 0.0f, 1.0f};
+    // record the main pass once per swapchain image and frame in flight and reuse it until invalidated, for static
+    // scenes. Has no effect with frame export or damage tracking, which change the recorded commands every frame. See
+    // SwapChainRenderer::invalidateRecordedCommands
+    bool cacheStaticCommandBuffers = false;
+    // while a final compute pass is registered, see SwapChainRenderer::setFinalComputePass, create the swapchain with a
+    // UNORM format and storage usage when the surface supports it so the pass writes to the swapchain image directly.
+    // The shader does the sRGB encoding, see shaders/SrgbEncode.glsl. Without a pass, or when unsupported, the usual
+    // sRGB format is used so raster output is still encoded
+    bool computeToSwapChain = false;
+    // redraw only the regions reported through SwapChainRenderer::addDamage instead of the whole image each frame, and
+    // present nothing while no damage is reported. Draws are limited with a scissor set before objects record, so
+    // objects must not set a scissor of their own
+    bool damageTracking = false;
+    // also tell the presentation engine which regions changed, requires VK_KHR_incremental_present which is enabled
+    // on the device when set
+    bool incrementalPresent = false;
+    // when set, frames are exported to consumer processes connecting to this unix socket, see FrameExporter
+    std::string frameExportSocketPath;
+    uint8_t frameExportRingSize = 4;
+    // convert each frame to YUV on the GPU and read it back, see SwapChainRenderer::setReadbackCallback
+    Readback_Format readbackFormat = Readback_Format::disabled;
+    // size frames are read back at, zero for the window's framebuffer size
+    vk::Extent2D readbackExtent{0, 0};
+    // also emit input as events on the device event bus, for listeners subscribing there directly rather than through
+    // the input policies. The policies' init(EventBus &) overloads already listen on the input bus
+    bool forwardInputToDeviceBus = false;
 };
-} // namespace star::windowing
\ No newline at end of file
+} // namespace star::windowing
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <star_common/HandleTypeRegistry.hpp>
 #include <star_common/IEvent.hpp>
 
 #include <string_view>
@@ -11,6 +12,15 @@ class KeyPress : public common::IEvent
   public:
     KeyPress(int key, int scancode, int mods);
 
+    /// <summary>
+    /// Registry type for this event, only looked up on first use
+    /// </summary>
+    static auto GetRegisteredType()
+    {
+        static const auto type = common::HandleTypeRegistry::instance().registerType(GetKeyPressedEventTypeName);
+        return type;
+    }
+
     int &getKey()
     {
         return m_key;
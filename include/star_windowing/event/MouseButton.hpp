@@ -1,5 +1,6 @@
 #pragma once
 
+#include <star_common/HandleTypeRegistry.hpp>
 #include <star_common/IEvent.hpp>
 #include <string_view>
 
@@ -10,6 +11,16 @@ class MouseButton : public common::IEvent
 {
   public:
     MouseButton(int button, int action, int mods);
+
+    /// <summary>
+    /// Registry type for this event, only looked up on first use
+    /// </summary>
+    static auto GetRegisteredType()
+    {
+        static const auto type = common::HandleTypeRegistry::instance().registerType(GetMouseButtonEventTypeName);
+        return type;
+    }
+
     virtual ~MouseButton() = default;
 
     int &getButton()
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <star_common/HandleTypeRegistry.hpp>
+#include <star_common/IEvent.hpp>
+#include <string_view>
+
+namespace star::windowing::event
+{
+constexpr std::string_view GetMouseDeltaEventTypeName = "star::windowing::MouseDelta";
+
+/// <summary>
+/// Relative cursor motion accumulated over one frame while the cursor is captured. Values are unaccelerated when the
+/// platform supports raw mouse motion.
+/// </summary>
+class MouseDelta : public common::IEvent
+{
+  public:
+    MouseDelta(double xdelta, double ydelta);
+
+    /// <summary>
+    /// Registry type for this event, only looked up on first use
+    /// </summary>
+    static auto GetRegisteredType()
+    {
+        static const auto type = common::HandleTypeRegistry::instance().registerType(GetMouseDeltaEventTypeName);
+        return type;
+    }
+
+    virtual ~MouseDelta() = default;
+
+    double &getXDelta()
+    {
+        return m_xdelta;
+    }
+    const double &getXDelta() const
+    {
+        return m_xdelta;
+    }
+    double &getYDelta()
+    {
+        return m_ydelta;
+    }
+    const double &getYDelta() const
+    {
+        return m_ydelta;
+    }
+
+  private:
+    double m_xdelta;
+    double m_ydelta;
+};
+} // namespace star::windowing::event
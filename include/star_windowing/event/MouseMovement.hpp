@@ -1,5 +1,6 @@
 #pragma once
 
+#include <star_common/HandleTypeRegistry.hpp>
 #include <star_common/IEvent.hpp>
 #include <string_view>
 
@@ -10,6 +11,16 @@ class MouseMovement : public common::IEvent
 {
   public:
     MouseMovement(double xpos, double ypos);
+
+    /// <summary>
+    /// Registry type for this event, only looked up on first use
+    /// </summary>
+    static auto GetRegisteredType()
+    {
+        static const auto type = common::HandleTypeRegistry::instance().registerType(GetMouseMovementEventTypeName);
+        return type;
+    }
+
     virtual ~MouseMovement() = default;
 
     double &getXPos()
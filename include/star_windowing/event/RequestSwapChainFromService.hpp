@@ -1,5 +1,6 @@
 #pragma once
 
+#include <star_common/HandleTypeRegistry.hpp>
 #include <star_common/IEvent.hpp>
 #include <vulkan/vulkan.hpp>
 
@@ -12,6 +13,16 @@ class RequestSwapChainFromService : public common::IEvent
   public:
     RequestSwapChainFromService(vk::SwapchainKHR &resultSwapchain);
 
+    /// <summary>
+    /// Registry type for this event, only looked up on first use
+    /// </summary>
+    static auto GetRegisteredType()
+    {
+        static const auto type =
+            common::HandleTypeRegistry::instance().registerType(GetRequestSwapChainFromServiceEventTypeName);
+        return type;
+    }
+
     virtual ~RequestSwapChainFromService() = default;
 
     vk::SwapchainKHR *getResultSwapChain() const
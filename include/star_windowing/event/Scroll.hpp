@@ -0,0 +1,51 @@
+#pragma once
+
+#include <star_common/HandleTypeRegistry.hpp>
+#include <star_common/IEvent.hpp>
+#include <string_view>
+
+namespace star::windowing::event
+{
+constexpr std::string_view GetScrollEventTypeName = "star::windowing::Scroll";
+
+/// <summary>
+/// Scroll wheel/touchpad offsets summed over one frame
+/// </summary>
+class Scroll : public common::IEvent
+{
+  public:
+    Scroll(double xoffset, double yoffset);
+
+    /// <summary>
+    /// Registry type for this event, only looked up on first use
+    /// </summary>
+    static auto GetRegisteredType()
+    {
+        static const auto type = common::HandleTypeRegistry::instance().registerType(GetScrollEventTypeName);
+        return type;
+    }
+
+    virtual ~Scroll() = default;
+
+    double &getXOffset()
+    {
+        return m_xoffset;
+    }
+    const double &getXOffset() const
+    {
+        return m_xoffset;
+    }
+    double &getYOffset()
+    {
+        return m_yoffset;
+    }
+    const double &getYOffset() const
+    {
+        return m_yoffset;
+    }
+
+  private:
+    double m_xoffset;
+    double m_yoffset;
+};
+} // namespace star::windowing::event
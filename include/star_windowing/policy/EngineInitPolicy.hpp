@@ -1,5 +1,6 @@
 #pragma once
 
+#include <star_windowing/SplashPresenter.hpp>
 #include <star_windowing/WindowingContext.hpp>
 #include <starlight/core/RenderingInstance.hpp>
 #include <starlight/core/device/StarDevice.hpp>
@@ -10,6 +11,7 @@
 #include <star_common/FrameTracker.hpp>
 #include <star_common/Renderer.hpp>
 
+#include <memory>
 #include <set>
 
 namespace star::windowing
@@ -37,6 +39,8 @@ class EngineInitPolicy
   private:
     WindowingContext &m_winContext;
     uint8_t m_maxNumFramesInFlight = 0;
+    // presents from device creation until the swapchain service creates the real swapchain
+    std::unique_ptr<SplashPresenter> m_splash;
 
     RenderingSurface createRenderingSurface(vk::Instance instance, StarWindow &window) const;
 
@@ -1,11 +1,14 @@
 #pragma once
 
+#include "star_windowing/FrameRateLimiter.hpp"
 #include "star_windowing/SwapChainRenderer.hpp"
 #include "star_windowing/WindowingContext.hpp"
 
 #include <star_common/Handle.hpp>
 #include <starlight/core/SystemContext.hpp>
 
+#include <functional>
+
 namespace star::windowing
 {
 class EngineMainLoopPolicy
@@ -14,11 +17,30 @@ class EngineMainLoopPolicy
     explicit EngineMainLoopPolicy(WindowingContext &winContext)
         : m_winContext(winContext)
     {
+        m_frameRateLimiter.setMaxFramesPerSecond(winContext.maxFramesPerSecond);
     }
-    
+
+    /// <summary>
+    /// Wait out the frame rate limit, if any, then gather input for the frame
+    /// </summary>
     void frameUpdate();
 
+    void setMaxFramesPerSecond(const double &maxFramesPerSecond)
+    {
+        m_winContext.maxFramesPerSecond = maxFramesPerSecond;
+        m_frameRateLimiter.setMaxFramesPerSecond(maxFramesPerSecond);
+    }
+
+    /// <summary>
+    /// Render a frame with renderFrame whenever the window needs to be redrawn in the middle of a resize, see
+    /// WindowingContext::refreshFrame. Pass one iteration of the engine loop, events are not pumped while it runs.
+    /// </summary>
+    void setRefreshFrame(std::function<void()> renderFrame);
+
   private:
     WindowingContext &m_winContext;
+    FrameRateLimiter m_frameRateLimiter;
+
+    void pumpEvents();
 };
-} // namespace star::windowing
\ No newline at end of file
+} // namespace star::windowing
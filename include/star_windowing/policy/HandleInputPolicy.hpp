@@ -0,0 +1,204 @@
+#pragma once
+
+#include <star_common/EventBus.hpp>
+#include <star_windowing/InputBus.hpp>
+#include <star_windowing/InteractivityBus.hpp>
+#include <star_windowing/event/KeyPress.hpp>
+#include <star_windowing/event/KeyRelease.hpp>
+#include <star_windowing/event/MouseButton.hpp>
+#include <star_windowing/event/MouseDelta.hpp>
+#include <star_windowing/event/MouseMovement.hpp>
+#include <star_windowing/event/Scroll.hpp>
+
+#include <type_traits>
+
+namespace star::windowing
+{
+/// <summary>
+/// Listen for several input events through one policy. Each event type is routed straight to the matching handler of
+/// T, which is picked at compile time:
+///     event::KeyPress      -> onKeyPress(key, scancode, mods)
+///     event::KeyRelease    -> onKeyRelease(key, scancode, mods)
+///     event::MouseButton   -> onMouseButtonAction(button, action, mods)
+///     event::MouseMovement -> onMouseMovement(xpos, ypos)
+///     event::MouseDelta    -> onMouseDelta(xdelta, ydelta)
+///     event::Scroll        -> onScroll(xoffset, yoffset)
+/// All handled events arrive through a single function pointer subscription. Key and mouse button events can optionally
+/// be limited to a set of codes, see init(inputBus, filter).
+/// </summary>
+template <typename T, typename... TEvents> class HandleInputPolicy
+{
+    static_assert(sizeof...(TEvents) > 0, "At least one event type must be handled");
+
+  public:
+    HandleInputPolicy(T &me) : me(me)
+    {
+    }
+    virtual ~HandleInputPolicy()
+    {
+        if (m_inputBus == nullptr)
+        {
+            return;
+        }
+
+        if (m_token != 0)
+        {
+            m_inputBus->unsubscribe(m_token);
+        }
+        if (m_filteredToken != 0)
+        {
+            m_inputBus->unsubscribe(m_filteredToken);
+        }
+    }
+
+    /// <summary>
+    /// For listeners written against the device event bus, which keys subscriptions by event type and would need one
+    /// per handled event. Subscribes once on the input bus of InteractivityBus instead.
+    /// </summary>
+    void init(common::EventBus &)
+    {
+        init(InteractivityBus::GetInputBus());
+    }
+
+    void init(InputBus &inputBus)
+    {
+        m_inputBus = &inputBus;
+        m_token = inputBus.subscribe((InputRecord::TypeBit(GetRecordType<TEvents>()) | ...),
+                                     &HandleInputPolicy::eventCallback, this);
+    }
+
+    /// <summary>
+    /// Only receive the handled events of the filter's source (key press/release for keys, mouse button actions for
+    /// buttons) for the codes in the filter. Handled events of other kinds are received as usual.
+    /// </summary>
+    void init(InputBus &inputBus, const InputFilter &filter)
+    {
+        m_inputBus = &inputBus;
+
+        uint32_t typeMask = 0, filteredTypeMask = 0;
+        (
+            [&] {
+                if (IsFilteredBy<TEvents>(filter.source))
+                {
+                    filteredTypeMask |= InputRecord::TypeBit(GetRecordType<TEvents>());
+                }
+                else
+                {
+                    typeMask |= InputRecord::TypeBit(GetRecordType<TEvents>());
+                }
+            }(),
+            ...);
+
+        if (typeMask != 0)
+        {
+            m_token = inputBus.subscribe(typeMask, &HandleInputPolicy::eventCallback, this);
+        }
+        if (filteredTypeMask != 0)
+        {
+            m_filteredToken = inputBus.subscribe(filter, filteredTypeMask, &HandleInputPolicy::eventCallback, this);
+        }
+    }
+
+  private:
+    T &me;
+    InputBus *m_inputBus = nullptr;
+    uint32_t m_token = 0;
+    uint32_t m_filteredToken = 0;
+
+    template <typename TEvent> static constexpr bool Handles()
+    {
+        return (std::is_same_v<TEvent, TEvents> || ...);
+    }
+
+    template <typename TEvent> static constexpr bool IsFilteredBy(const Input_Source &source)
+    {
+        if constexpr (std::is_same_v<TEvent, event::KeyPress> || std::is_same_v<TEvent, event::KeyRelease>)
+        {
+            return source == Input_Source::key;
+        }
+        else if constexpr (std::is_same_v<TEvent, event::MouseButton>)
+        {
+            return source == Input_Source::mouse_button;
+        }
+        return false;
+    }
+
+    template <typename TEvent> static constexpr InputRecord::Type GetRecordType()
+    {
+        if constexpr (std::is_same_v<TEvent, event::KeyPress>)
+        {
+            return InputRecord::Type::key_press;
+        }
+        else if constexpr (std::is_same_v<TEvent, event::KeyRelease>)
+        {
+            return InputRecord::Type::key_release;
+        }
+        else if constexpr (std::is_same_v<TEvent, event::MouseButton>)
+        {
+            return InputRecord::Type::mouse_button;
+        }
+        else if constexpr (std::is_same_v<TEvent, event::MouseMovement>)
+        {
+            return InputRecord::Type::mouse_movement;
+        }
+        else if constexpr (std::is_same_v<TEvent, event::MouseDelta>)
+        {
+            return InputRecord::Type::mouse_delta;
+        }
+        else if constexpr (std::is_same_v<TEvent, event::Scroll>)
+        {
+            return InputRecord::Type::scroll;
+        }
+        else
+        {
+            static_assert(sizeof(TEvent) == 0, "HandleInputPolicy does not know how to dispatch this event type");
+        }
+    }
+
+    static void eventCallback(void *context, const InputRecord &record)
+    {
+        auto *policy = static_cast<HandleInputPolicy *>(context);
+
+        switch (record.type)
+        {
+        case InputRecord::Type::key_press:
+            if constexpr (Handles<event::KeyPress>())
+            {
+                policy->me.onKeyPress(record.key.key, record.key.scancode, record.key.mods);
+            }
+            break;
+        case InputRecord::Type::key_release:
+            if constexpr (Handles<event::KeyRelease>())
+            {
+                policy->me.onKeyRelease(record.key.key, record.key.scancode, record.key.mods);
+            }
+            break;
+        case InputRecord::Type::mouse_button:
+            if constexpr (Handles<event::MouseButton>())
+            {
+                policy->me.onMouseButtonAction(record.mouseButton.button, record.mouseButton.action,
+                                               record.mouseButton.mods);
+            }
+            break;
+        case InputRecord::Type::mouse_movement:
+            if constexpr (Handles<event::MouseMovement>())
+            {
+                policy->me.onMouseMovement(record.cursor.xpos, record.cursor.ypos);
+            }
+            break;
+        case InputRecord::Type::mouse_delta:
+            if constexpr (Handles<event::MouseDelta>())
+            {
+                policy->me.onMouseDelta(record.cursor.xpos, record.cursor.ypos);
+            }
+            break;
+        case InputRecord::Type::scroll:
+            if constexpr (Handles<event::Scroll>())
+            {
+                policy->me.onScroll(record.cursor.xpos, record.cursor.ypos);
+            }
+            break;
+        }
+    }
+};
+} // namespace star::windowing
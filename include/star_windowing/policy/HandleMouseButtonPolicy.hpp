@@ -1,6 +1,8 @@
 #pragma once
 
-#include <star_windowing/event/MouseButton.hpp>
+#include <star_common/EventBus.hpp>
+#include <star_windowing/InputBus.hpp>
+#include <star_windowing/InteractivityBus.hpp>
 
 namespace star::windowing
 {
@@ -10,48 +12,40 @@ template <typename T> class HandleMouseButtonPolicy
     HandleMouseButtonPolicy(T &me) : me(me)
     {
     }
-    virtual ~HandleMouseButtonPolicy() = default;
-
-    void init(common::EventBus &eventBus)
+    virtual ~HandleMouseButtonPolicy()
     {
-        registerListener(eventBus); 
+        if (m_inputBus != nullptr && m_token != 0)
+        {
+            m_inputBus->unsubscribe(m_token);
+        }
     }
 
-  private:
-    T &me;
-    Handle m_callbackRegistration;
-
-    void registerListener(common::EventBus &eventBus)
+    /// <summary>
+    /// Kept for listeners written against the device event bus, input is delivered on the input bus of
+    /// InteractivityBus instead
+    /// </summary>
+    void init(common::EventBus &)
     {
-        eventBus.subscribe(
-            common::HandleTypeRegistry::instance().registerType(event::GetMouseButtonEventTypeName),
-            common::SubscriberCallbackInfo{std::bind(&HandleMouseButtonPolicy<T>::eventCallback, this,
-                                                     std::placeholders::_1, std::placeholders::_2),
-                                           std::bind(&HandleMouseButtonPolicy<T>::getHandleForEventBus, this),
-                                           std::bind(&HandleMouseButtonPolicy<T>::notificationFromEventBusOfDeletion,
-                                                     this, std::placeholders::_1)});
+        init(InteractivityBus::GetInputBus());
     }
 
-    void eventCallback(const common::IEvent &e, bool &keepAlive)
+    void init(InputBus &inputBus)
     {
-        const auto &event = static_cast<const event::MouseButton &>(e);
-
-        me.onMouseButtonAction(event.getButton(), event.getAction(), event.getMods());
-
-        keepAlive = true;
+        m_inputBus = &inputBus;
+        m_token = inputBus.subscribe(InputRecord::TypeBit(InputRecord::Type::mouse_button),
+                                     &HandleMouseButtonPolicy<T>::eventCallback, this);
     }
 
-    Handle *getHandleForEventBus()
-    {
-        return &m_callbackRegistration;
-    }
+  private:
+    T &me;
+    InputBus *m_inputBus = nullptr;
+    uint32_t m_token = 0;
 
-    void notificationFromEventBusOfDeletion(const Handle &noLongerNeededHandle)
+    static void eventCallback(void *context, const InputRecord &record)
     {
-        if (m_callbackRegistration == noLongerNeededHandle)
-        {
-            m_callbackRegistration = Handle();
-        }
+        auto *policy = static_cast<HandleMouseButtonPolicy<T> *>(context);
+
+        policy->me.onMouseButtonAction(record.mouseButton.button, record.mouseButton.action, record.mouseButton.mods);
     }
 };
-} // namespace star::windowing
\ No newline at end of file
+} // namespace star::windowing
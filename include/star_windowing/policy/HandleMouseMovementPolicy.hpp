@@ -1,10 +1,8 @@
 #pragma once
 
-#include "star_windowing/event/MouseMovement.hpp"
-
 #include <star_common/EventBus.hpp>
-#include <star_common/Handle.hpp>
-#include <star_common/HandleTypeRegistry.hpp>
+#include <star_windowing/InputBus.hpp>
+#include <star_windowing/InteractivityBus.hpp>
 
 namespace star::windowing
 {
@@ -14,48 +12,40 @@ template <typename T> class HandleMouseMovementPolicy
     HandleMouseMovementPolicy(T &me) : me(me)
     {
     }
-    virtual ~HandleMouseMovementPolicy() = default;
-
-    void init(common::EventBus &eventBus)
+    virtual ~HandleMouseMovementPolicy()
     {
-        registerListener(eventBus);
+        if (m_inputBus != nullptr && m_token != 0)
+        {
+            m_inputBus->unsubscribe(m_token);
+        }
     }
 
-  private:
-    T &me;
-    Handle m_callbackRegistration;
-
-    void registerListener(common::EventBus &eventBus)
+    /// <summary>
+    /// Kept for listeners written against the device event bus, input is delivered on the input bus of
+    /// InteractivityBus instead
+    /// </summary>
+    void init(common::EventBus &)
     {
-        eventBus.subscribe(
-            common::HandleTypeRegistry::instance().registerType(event::GetMouseMovementEventTypeName),
-            common::SubscriberCallbackInfo{std::bind(&HandleMouseMovementPolicy<T>::eventCallback, this,
-                                                     std::placeholders::_1, std::placeholders::_2),
-                                           std::bind(&HandleMouseMovementPolicy<T>::getHandleForEventBus, this),
-                                           std::bind(&HandleMouseMovementPolicy<T>::notificationFromEventBusOfDeletion,
-                                                     this, std::placeholders::_1)});
+        init(InteractivityBus::GetInputBus());
     }
 
-    void eventCallback(const common::IEvent &e, bool &keepAlive)
+    void init(InputBus &inputBus)
     {
-        const auto &event = static_cast<const event::MouseMovement &>(e);
-
-        me.onMouseMovement(event.getXPos(), event.getYPos());
-
-        keepAlive = true;
+        m_inputBus = &inputBus;
+        m_token = inputBus.subscribe(InputRecord::TypeBit(InputRecord::Type::mouse_movement),
+                                     &HandleMouseMovementPolicy<T>::eventCallback, this);
     }
 
-    Handle *getHandleForEventBus()
-    {
-        return &m_callbackRegistration;
-    }
+  private:
+    T &me;
+    InputBus *m_inputBus = nullptr;
+    uint32_t m_token = 0;
 
-    void notificationFromEventBusOfDeletion(const Handle &noLongerNeededHandle)
+    static void eventCallback(void *context, const InputRecord &record)
     {
-        if (m_callbackRegistration == noLongerNeededHandle)
-        {
-            m_callbackRegistration = Handle();
-        }
+        auto *policy = static_cast<HandleMouseMovementPolicy<T> *>(context);
+
+        policy->me.onMouseMovement(record.cursor.xpos, record.cursor.ypos);
     }
 };
-} // namespace star::windowing
\ No newline at end of file
+} // namespace star::windowing
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <star_common/EventBus.hpp>
+#include <star_windowing/InputBus.hpp>
+#include <star_windowing/InteractivityBus.hpp>
+
+namespace star::windowing
+{
+template <typename T> class HandleScrollPolicy
+{
+  public:
+    HandleScrollPolicy(T &me) : me(me)
+    {
+    }
+    virtual ~HandleScrollPolicy()
+    {
+        if (m_inputBus != nullptr && m_token != 0)
+        {
+            m_inputBus->unsubscribe(m_token);
+        }
+    }
+
+    /// <summary>
+    /// Kept for listeners written against the device event bus, input is delivered on the input bus of
+    /// InteractivityBus instead
+    /// </summary>
+    void init(common::EventBus &)
+    {
+        init(InteractivityBus::GetInputBus());
+    }
+
+    void init(InputBus &inputBus)
+    {
+        m_inputBus = &inputBus;
+        m_token = inputBus.subscribe(InputRecord::TypeBit(InputRecord::Type::scroll),
+                                     &HandleScrollPolicy<T>::eventCallback, this);
+    }
+
+  private:
+    T &me;
+    InputBus *m_inputBus = nullptr;
+    uint32_t m_token = 0;
+
+    static void eventCallback(void *context, const InputRecord &record)
+    {
+        auto *policy = static_cast<HandleScrollPolicy<T> *>(context);
+
+        policy->me.onScroll(record.cursor.xpos, record.cursor.ypos);
+    }
+};
+} // namespace star::windowing
@@ -43,7 +43,7 @@ template <typename TListener> class ListenForRequestForSwapChainPolicy
     void registerListener(common::EventBus &eventBus)
     {
         eventBus.subscribe(
-            common::HandleTypeRegistry::instance().registerType(event::GetRequestSwapChainFromServiceEventTypeName),
+            event::RequestSwapChainFromService::GetRegisteredType(),
             common::SubscriberCallbackInfo{
                 std::bind(&ListenForRequestForSwapChainPolicy<TListener>::eventCallback, this, std::placeholders::_1,
                           std::placeholders::_2),
@@ -52,11 +52,34 @@ class SwapChainControllerService : private ListenForRequestForSwapChainPolicy<Sw
     common::EventBus *m_deviceEventBus = nullptr;
     common::FrameTracker *m_deviceFrameTracker = nullptr;
     core::device::StarDevice *m_device = nullptr;
+    // acquire reported the swapchain no longer matches the surface exactly, handled like a resize
+    bool m_isSwapChainSuboptimal = false;
+    uint32_t m_framesPresentedSinceResize = 0;
+    // frames in flight currently cycled through, see WindowingContext::activeFramesInFlight
+    uint8_t m_activeFramesInFlight = 0;
 
     void initListeners(common::EventBus &eventBus); 
 
-    uint8_t incrementNextFrameInFlight(const common::FrameTracker &frameTracker) const noexcept;
+    uint8_t incrementNextFrameInFlight(const common::FrameTracker &frameTracker) noexcept;
+
+    /// <summary>
+    /// Requested number of active frames in flight, limited to what was allocated
+    /// </summary>
+    uint8_t getRequestedFramesInFlight(const uint8_t &maxFramesInFlight) const noexcept;
 
     uint8_t incrementNextSwapChainImage(const common::FrameTracker &frameTracker); 
+
+    /// <summary>
+    /// Rebuilding on every size change during a drag would rebuild every few pixels. Instead wait until the size has
+    /// settled or enough frames were shown at the old size, which the compositor scales in the meantime.
+    /// </summary>
+    bool shouldRebuildSwapChain();
+
+    bool isWindowMinimized() const;
+
+    /// <summary>
+    /// Returns false when the swapchain was kept because the window is minimized
+    /// </summary>
+    bool rebuildSwapChain();
 };
 } // namespace star::windowing
\ No newline at end of file
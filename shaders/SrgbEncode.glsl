@@ -0,0 +1,20 @@
+#ifndef STAR_WINDOWING_SRGB_ENCODE_GLSL
+#define STAR_WINDOWING_SRGB_ENCODE_GLSL
+
+// sRGB transfer function, for shaders writing linear color to a UNORM image which is displayed as sRGB, such as a
+// storage swapchain image (see WindowingContext::computeToSwapChain). Values are expected in [0, 1].
+
+vec3 EncodeSrgb(const vec3 linear)
+{
+    const vec3 low = linear * 12.92;
+    const vec3 high = 1.055 * pow(linear, vec3(1.0 / 2.4)) - 0.055;
+    return mix(high, low, lessThanEqual(linear, vec3(0.0031308)));
+}
+
+// alpha is not gamma encoded
+vec4 EncodeSrgb(const vec4 linear)
+{
+    return vec4(EncodeSrgb(linear.rgb), linear.a);
+}
+
+#endif
@@ -0,0 +1,90 @@
+#include "star_windowing/ActionMap.hpp"
+
+#include <cassert>
+
+namespace star::windowing
+{
+void ActionMap::bind(const Input_Source &source, const int &code, const ActionID &action)
+{
+    assert(IsValidInputCode(source, code) && action < MaxActions);
+
+    const size_t index = GetInputCodeIndex(source, code);
+    if (m_inputDown[index])
+    {
+        // carry a held input over to its new action
+        releaseAction(m_bindings[index]);
+        m_bindings[index] = action;
+        pressAction(action);
+        return;
+    }
+
+    m_bindings[index] = action;
+}
+
+void ActionMap::unbind(const Input_Source &source, const int &code)
+{
+    assert(IsValidInputCode(source, code));
+
+    const size_t index = GetInputCodeIndex(source, code);
+    if (m_inputDown[index])
+    {
+        releaseAction(m_bindings[index]);
+    }
+
+    m_bindings[index] = Unbound;
+}
+
+void ActionMap::processInput(const Input_Source &source, const int &code, const bool &isPressed)
+{
+    if (!IsValidInputCode(source, code))
+    {
+        return;
+    }
+
+    const size_t index = GetInputCodeIndex(source, code);
+    if (m_inputDown[index] == isPressed)
+    {
+        return;
+    }
+    m_inputDown[index] = isPressed;
+
+    if (isPressed)
+    {
+        pressAction(m_bindings[index]);
+    }
+    else
+    {
+        releaseAction(m_bindings[index]);
+    }
+}
+
+void ActionMap::pressAction(const ActionID &action)
+{
+    if (action == Unbound)
+    {
+        return;
+    }
+
+    if (m_holdCount[action]++ == 0)
+    {
+        const uint64_t bit = uint64_t{1} << action;
+        m_held |= bit;
+        m_pressedThisFrame |= bit;
+    }
+}
+
+void ActionMap::releaseAction(const ActionID &action)
+{
+    if (action == Unbound || m_holdCount[action] == 0)
+    {
+        return;
+    }
+
+    if (--m_holdCount[action] == 0)
+    {
+        const uint64_t bit = uint64_t{1} << action;
+        m_held &= ~bit;
+        m_releasedThisFrame |= bit;
+    }
+}
+} // namespace star::windowing
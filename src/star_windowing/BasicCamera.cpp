@@ -1,22 +1,19 @@
 #include "star_windowing/BasicCamera.hpp"
 
 #include <star_common/HandleTypeRegistry.hpp>
-#include <star_windowing/event/MouseMovement.hpp>
+#include <star_windowing/InteractivityBus.hpp>
 
 #include <GLFW/glfw3.h>
 
 namespace star::windowing
 {
 BasicCamera::BasicCamera()
-    : HandleMouseMovementPolicy<BasicCamera>(*this), HandleMouseButtonPolicy<BasicCamera>(*this),
-      HandleKeyPressPolicy<BasicCamera>(*this), HandleKeyReleasePolicy<BasicCamera>(*this)
+    : InputPolicy(*this)
 {
 }
 
 BasicCamera::BasicCamera(const uint32_t &width, const uint32_t &height)
-    : star::StarCamera(width, height), HandleMouseMovementPolicy<BasicCamera>(*this),
-      HandleMouseButtonPolicy<BasicCamera>(*this), HandleKeyPressPolicy<BasicCamera>(*this),
-      HandleKeyReleasePolicy<BasicCamera>(*this)
+    : star::StarCamera(width, height), InputPolicy(*this)
 {
 }
 
@@ -24,22 +21,20 @@ BasicCamera::BasicCamera(const uint32_t &width, const uint32_t &height, const fl
                          const float &nearClippingPlaneDistance, const float &farClippingPlaneDistance,
                          const float &movementSpeed, const float &sensitivity)
     : star::StarCamera(width, height, horizontalFieldOfView, nearClippingPlaneDistance, farClippingPlaneDistance),
-      HandleMouseMovementPolicy<BasicCamera>(*this), HandleMouseButtonPolicy<BasicCamera>(*this),
-      HandleKeyPressPolicy<BasicCamera>(*this), HandleKeyReleasePolicy<BasicCamera>(*this),
-      movementSpeed(movementSpeed), sensitivity(sensitivity)
+      InputPolicy(*this), movementSpeed(movementSpeed), sensitivity(sensitivity)
 {
 }
 
 BasicCamera::~BasicCamera()
 {
+    InteractivityBus::UnregisterActionMap(m_actions);
 }
 
 void BasicCamera::init(common::EventBus &eventBus)
 {
-    HandleMouseMovementPolicy<BasicCamera>::init(eventBus);
-    HandleMouseButtonPolicy<BasicCamera>::init(eventBus);
-    HandleKeyPressPolicy<BasicCamera>::init(eventBus);
-    HandleKeyReleasePolicy<BasicCamera>::init(eventBus);
+    InputPolicy::init(InteractivityBus::GetInputBus());
+
+    InteractivityBus::RegisterActionMap(m_actions);
 }
 
 void BasicCamera::onMouseMovement(const double &xpos, const double &ypos)
@@ -54,131 +49,146 @@ void BasicCamera::onMouseMovement(const double &xpos, const double &ypos)
             m_init = true;
         }
 
-        this->xMovement = xpos - this->prevX;
-        this->yMovement = ypos - this->prevY;
+        // several cursor events can arrive within one frame, all of them count
+        this->xMovement += xpos - this->prevX;
+        this->yMovement += ypos - this->prevY;
         this->prevX = xpos;
         this->prevY = ypos;
     }
 }
 
-void BasicCamera::frameUpdate(core::device::DeviceContext &context, const uint8_t &frameInFlightIndex)
+void BasicCamera::onMouseDelta(const double &xdelta, const double &ydelta)
 {
+    this->capturedXMovement += static_cast<float>(xdelta);
+    this->capturedYMovement += static_cast<float>(ydelta);
+}
 
-    if ((double)time.timeElapsedLastFrameSeconds() > 1)
+void BasicCamera::frameUpdate(core::device::DeviceContext &context, const uint8_t &frameInFlightIndex)
+{
+    if (glm::vec3(this->getForwardVector()) != m_renderedForward)
     {
-        time.updateLastFrameTime();
+        // rotated through StarCamera since the last update
+        markDirty();
     }
 
-    if (moveLeft || moveRight || moveForward || moveBack)
+    // look is applied as soon as it arrives, stepping it would only add latency
+    // mouse movement is consumed once applied, nothing to do until the cursor moves again
+    if (this->xMovement != 0.0f || this->yMovement != 0.0f)
     {
-        float moveAmt = this->movementSpeed * time.timeElapsedLastFrameSeconds();
-
-        glm::vec3 cameraLookDir = this->getForwardVector();
-
-        if (moveLeft)
-        {
-            this->moveRelative(glm::cross(glm::vec3(this->getForwardVector()), -glm::vec3(this->getUpVector())),
-                               moveAmt);
-        }
-        if (moveRight)
-        {
-            this->moveRelative(glm::cross(glm::vec3(this->getForwardVector()), glm::vec3(this->getUpVector())),
-                               moveAmt);
-        }
-        if (moveForward)
-        {
-            this->moveRelative(this->getForwardVector(), moveAmt);
-        }
-        if (moveBack)
-        {
-            this->moveRelative(-this->getForwardVector(), moveAmt);
-        }
+        applyLookRotation(this->xMovement * this->sensitivity, this->yMovement * this->sensitivity);
 
-        time.updateLastFrameTime();
+        this->xMovement = 0.0f;
+        this->yMovement = 0.0f;
     }
 
-    if (m_init)
+    if (this->capturedXMovement != 0.0f || this->capturedYMovement != 0.0f)
     {
-        this->xMovement *= this->sensitivity;
-        this->yMovement *= this->sensitivity;
-
-        this->yaw += this->xMovement;
-        this->pitch += this->yMovement;
+        applyLookRotation(this->capturedXMovement * this->sensitivity, this->capturedYMovement * this->sensitivity);
 
-        // apply restrictions due to const up vector for the camera
-        if (this->pitch > 89.0f)
-        {
-            pitch = 89.0f;
-        }
-        if (this->pitch < -89.0f)
-        {
-            pitch = -89.0f;
-        }
+        this->capturedXMovement = 0.0f;
+        this->capturedYMovement = 0.0f;
+    }
 
-        glm::vec3 direction{cos(glm::radians(this->yaw)) * cos(glm::radians(this->pitch)),
-                            sin(glm::radians(this->pitch)),
-                            sin(glm::radians(this->yaw)) * cos(glm::radians(this->pitch))};
+    simulateMovement();
+    m_renderedForward = glm::vec3(this->getForwardVector());
 
-        this->setForwardVector(glm::vec4(glm::normalize(direction), 0.0));
-    }
+    const uint32_t frameBit = 1u << frameInFlightIndex;
+    m_uploadFrames = m_dirtyFrames & frameBit;
+    m_dirtyFrames &= ~frameBit;
 }
 
-void BasicCamera::onMouseButtonAction(const int &button, const int &action, const int &mods)
+void BasicCamera::simulateMovement()
 {
-    if (action == GLFW_PRESS && button == GLFW_MOUSE_BUTTON_LEFT)
+    const uint32_t numSteps = m_simulationClock.advance();
+    const glm::vec3 position = glm::vec3(this->getPosition());
+
+    if (!m_hasSimulatedPosition || position != m_renderedPosition)
     {
-        this->click = true;
+        // first update, or the camera was placed by something else. Continue the simulation from there.
+        m_previousPosition = position;
+        m_currentPosition = position;
+        m_hasSimulatedPosition = true;
+        markDirty();
     }
-    else if (this->click && button == GLFW_MOUSE_BUTTON_LEFT)
+
+    const glm::vec3 stepDisplacement =
+        calculateStepDisplacement(static_cast<float>(m_simulationClock.getStepSeconds()));
+    for (uint32_t i = 0; i < numSteps; i++)
     {
-        this->click = false;
-        m_init = false;
+        m_previousPosition = m_currentPosition;
+        m_currentPosition += stepDisplacement;
     }
+
+    const glm::vec3 rendered = glm::mix(m_previousPosition, m_currentPosition, m_simulationClock.getAlpha());
+    if (rendered != position)
+    {
+        const glm::vec3 offset = rendered - position;
+        this->moveRelative(glm::normalize(offset), glm::length(offset));
+        markDirty();
+    }
+
+    m_renderedPosition = glm::vec3(this->getPosition());
 }
 
-void BasicCamera::onKeyPress(const int &key, const int &scancode, const int &mods)
+glm::vec3 BasicCamera::calculateStepDisplacement(const float &stepSeconds)
 {
-    // TODO: improve time var allocation
-    // bool moveLeft = KeyStates::state(A);
-    // bool moveRight = KeyStates::state(D);
-    // bool moveForward = KeyStates::state(W);
-    // bool moveBack = KeyStates::state(S);
+    const glm::vec3 forward = glm::vec3(this->getForwardVector());
+    const glm::vec3 right = glm::normalize(glm::cross(forward, glm::vec3(this->getUpVector())));
 
-    if (key == GLFW_KEY_A)
+    glm::vec3 direction{0.0f};
+    if (m_actions.isHeld(move_left))
     {
-        moveLeft = true;
+        direction -= right;
     }
-    if (key == GLFW_KEY_D)
+    if (m_actions.isHeld(move_right))
     {
-        moveRight = true;
+        direction += right;
     }
-    if (key == GLFW_KEY_W)
+    if (m_actions.isHeld(move_forward))
     {
-        moveForward = true;
+        direction += forward;
     }
-    if (key == GLFW_KEY_S)
+    if (m_actions.isHeld(move_back))
     {
-        moveBack = true;
+        direction -= forward;
     }
+
+    return direction * this->movementSpeed * stepSeconds;
 }
 
-void BasicCamera::onKeyRelease(const int &key, const int &scancode, const int &mods)
+void BasicCamera::applyLookRotation(const float &yawChange, const float &pitchChange)
 {
-    if (key == GLFW_KEY_A)
-    {
-        moveLeft = false;
-    }
-    else if (key == GLFW_KEY_D)
-    {
-        moveRight = false;
-    }
-    else if (key == GLFW_KEY_W)
+    this->yaw += yawChange;
+    this->pitch = ClampPitch(this->pitch + pitchChange);
+
+    this->setForwardVector(glm::vec4(CalculateDirection(this->yaw, this->pitch), 0.0));
+    markDirty();
+}
+
+float BasicCamera::ClampPitch(const float &pitch)
+{
+    // apply restrictions due to const up vector for the camera
+    return glm::clamp(pitch, -89.0f, 89.0f);
+}
+
+glm::vec3 BasicCamera::CalculateDirection(const float &yaw, const float &pitch)
+{
+    glm::vec3 direction{cos(glm::radians(yaw)) * cos(glm::radians(pitch)), sin(glm::radians(pitch)),
+                        sin(glm::radians(yaw)) * cos(glm::radians(pitch))};
+
+    return glm::normalize(direction);
+}
+
+void BasicCamera::onMouseButtonAction(const int &button, const int &action, const int &mods)
+{
+    if (action == GLFW_PRESS && button == GLFW_MOUSE_BUTTON_LEFT)
     {
-        moveForward = false;
+        this->click = true;
     }
-    else if (key == GLFW_KEY_S)
+    else if (this->click && button == GLFW_MOUSE_BUTTON_LEFT)
     {
-        moveBack = false;
+        this->click = false;
+        m_init = false;
     }
 }
 
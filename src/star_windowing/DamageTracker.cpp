@@ -0,0 +1,116 @@
+#include "star_windowing/DamageTracker.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace star::windowing
+{
+void DamageTracker::reset(const uint32_t &numImages, const vk::Extent2D &extent)
+{
+    m_extent = extent;
+    m_images.assign(numImages, Damage{});
+    m_frameDamage = Damage{};
+    m_redrawFull = true;
+    m_presentFull = true;
+    m_redrawRegions.clear();
+    m_presentRegions.clear();
+}
+
+void DamageTracker::addDamage(const vk::Rect2D &region)
+{
+    // clip to the image, regions entirely outside of it are dropped
+    const int32_t left = std::max(region.offset.x, 0);
+    const int32_t top = std::max(region.offset.y, 0);
+    const int32_t right =
+        std::min(region.offset.x + static_cast<int32_t>(region.extent.width), static_cast<int32_t>(m_extent.width));
+    const int32_t bottom =
+        std::min(region.offset.y + static_cast<int32_t>(region.extent.height), static_cast<int32_t>(m_extent.height));
+    if (right <= left || bottom <= top)
+    {
+        return;
+    }
+
+    const vk::Rect2D clipped{{left, top}, {static_cast<uint32_t>(right - left), static_cast<uint32_t>(bottom - top)}};
+    for (auto &image : m_images)
+    {
+        image.add(clipped);
+    }
+    m_frameDamage.add(clipped);
+}
+
+void DamageTracker::damageAll()
+{
+    for (auto &image : m_images)
+    {
+        image = Damage{};
+    }
+    m_frameDamage = Damage{};
+}
+
+void DamageTracker::beginImage(const uint32_t &imageIndex)
+{
+    assert(imageIndex < m_images.size());
+
+    Damage &image = m_images[imageIndex];
+    m_redrawFull = image.full;
+    m_redrawRegions.swap(image.regions);
+    image.full = false;
+    image.regions.clear();
+
+    m_presentFull = m_frameDamage.full;
+    m_presentRegions.swap(m_frameDamage.regions);
+    m_frameDamage.full = false;
+    m_frameDamage.regions.clear();
+}
+
+vk::Rect2D DamageTracker::getRedrawBounds() const
+{
+    if (m_redrawFull)
+    {
+        return vk::Rect2D({0, 0}, m_extent);
+    }
+    if (m_redrawRegions.empty())
+    {
+        return vk::Rect2D({0, 0}, {0, 0});
+    }
+
+    vk::Rect2D bounds = m_redrawRegions.front();
+    for (const auto &region : m_redrawRegions)
+    {
+        bounds = Union(bounds, region);
+    }
+    return bounds;
+}
+
+void DamageTracker::Damage::add(const vk::Rect2D &region)
+{
+    if (full)
+    {
+        return;
+    }
+
+    if (regions.size() < MaxRegions)
+    {
+        regions.push_back(region);
+        return;
+    }
+
+    vk::Rect2D bounds = region;
+    for (const auto &existing : regions)
+    {
+        bounds = Union(bounds, existing);
+    }
+    regions.assign(1, bounds);
+}
+
+vk::Rect2D DamageTracker::Union(const vk::Rect2D &a, const vk::Rect2D &b)
+{
+    const int32_t left = std::min(a.offset.x, b.offset.x);
+    const int32_t top = std::min(a.offset.y, b.offset.y);
+    const int32_t right = std::max(a.offset.x + static_cast<int32_t>(a.extent.width),
+                                   b.offset.x + static_cast<int32_t>(b.extent.width));
+    const int32_t bottom = std::max(a.offset.y + static_cast<int32_t>(a.extent.height),
+                                    b.offset.y + static_cast<int32_t>(b.extent.height));
+    return vk::Rect2D{{left, top}, {static_cast<uint32_t>(right - left), static_cast<uint32_t>(bottom - top)}};
+}
+} // namespace star::windowing
@@ -0,0 +1,205 @@
+#include "star_windowing/FrameExportServer.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__unix__)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace star::windowing
+{
+FrameExportServer::~FrameExportServer()
+{
+    stop();
+}
+
+#if defined(__unix__)
+void FrameExportServer::start(const std::string &socketPath)
+{
+    sockaddr_un address{};
+    if (socketPath.size() >= sizeof(address.sun_path))
+    {
+        throw std::runtime_error("Frame export socket path is too long: " + socketPath);
+    }
+
+    stop();
+
+    m_listenSocket = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (m_listenSocket < 0)
+    {
+        throw std::runtime_error("Failed to create frame export socket: " + std::string(std::strerror(errno)));
+    }
+
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size());
+
+    // a previous run which did not shut down cleanly leaves the socket file behind
+    unlink(socketPath.c_str());
+    if (bind(m_listenSocket, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0 ||
+        listen(m_listenSocket, 4) != 0)
+    {
+        const std::string error = std::strerror(errno);
+        close(m_listenSocket);
+        m_listenSocket = -1;
+        throw std::runtime_error("Failed to listen on frame export socket " + socketPath + ": " + error);
+    }
+
+    m_socketPath = socketPath;
+}
+
+void FrameExportServer::stop()
+{
+    while (!m_clients.empty())
+    {
+        dropClient(m_clients.size() - 1);
+    }
+
+    if (m_listenSocket >= 0)
+    {
+        close(m_listenSocket);
+        m_listenSocket = -1;
+        unlink(m_socketPath.c_str());
+        m_socketPath.clear();
+    }
+}
+
+void FrameExportServer::acceptClients(const FrameExportRingInfo &info, const std::vector<int> &sharedFds)
+{
+    if (m_listenSocket < 0)
+    {
+        return;
+    }
+
+    int clientSocket = -1;
+    while ((clientSocket = accept4(m_listenSocket, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0)
+    {
+        if (!SendMessage(clientSocket, &info, sizeof(info), sharedFds))
+        {
+            close(clientSocket);
+            continue;
+        }
+
+        m_clients.push_back(Client{.socket = clientSocket});
+    }
+}
+
+void FrameExportServer::collectReleases()
+{
+    for (size_t i = m_clients.size(); i > 0; i--)
+    {
+        Client &client = m_clients[i - 1];
+
+        FrameExportRelease release{};
+        ssize_t received = 0;
+        while ((received = recv(client.socket, &release, sizeof(release), 0)) == sizeof(release))
+        {
+            if (release.slot < 64)
+            {
+                client.heldSlots &= ~(uint64_t(1) << release.slot);
+            }
+        }
+
+        // zero means the consumer hung up
+        if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK))
+        {
+            dropClient(i - 1);
+        }
+    }
+}
+
+void FrameExportServer::broadcast(const FrameExportMessage &message)
+{
+    for (size_t i = m_clients.size(); i > 0; i--)
+    {
+        Client &client = m_clients[i - 1];
+        if (!SendMessage(client.socket, &message, sizeof(message), {}))
+        {
+            // a consumer which stopped reading is dropped rather than allowed to stall the renderer
+            dropClient(i - 1);
+            continue;
+        }
+
+        client.heldSlots |= uint64_t(1) << message.slot;
+    }
+}
+
+bool FrameExportServer::SendMessage(const int &socket, const void *data, const size_t &size,
+                                    const std::vector<int> &fds)
+{
+    iovec iov{.iov_base = const_cast<void *>(data), .iov_len = size};
+
+    msghdr message{};
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+
+    std::vector<char> control;
+    if (!fds.empty())
+    {
+        control.resize(CMSG_SPACE(sizeof(int) * fds.size()));
+        message.msg_control = control.data();
+        message.msg_controllen = control.size();
+
+        cmsghdr *header = CMSG_FIRSTHDR(&message);
+        header->cmsg_level = SOL_SOCKET;
+        header->cmsg_type = SCM_RIGHTS;
+        header->cmsg_len = CMSG_LEN(sizeof(int) * fds.size());
+        std::memcpy(CMSG_DATA(header), fds.data(), sizeof(int) * fds.size());
+    }
+
+    return sendmsg(socket, &message, MSG_NOSIGNAL) == static_cast<ssize_t>(size);
+}
+
+void FrameExportServer::dropClient(const size_t &index)
+{
+    close(m_clients[index].socket);
+    m_clients.erase(m_clients.begin() + index);
+}
+#else
+void FrameExportServer::start(const std::string &)
+{
+    throw std::runtime_error("Frame export is only supported on unix platforms");
+}
+
+void FrameExportServer::stop()
+{
+}
+
+void FrameExportServer::acceptClients(const FrameExportRingInfo &, const std::vector<int> &)
+{
+}
+
+void FrameExportServer::collectReleases()
+{
+}
+
+void FrameExportServer::broadcast(const FrameExportMessage &)
+{
+}
+
+bool FrameExportServer::SendMessage(const int &, const void *, const size_t &, const std::vector<int> &)
+{
+    return false;
+}
+
+void FrameExportServer::dropClient(const size_t &)
+{
+}
+#endif
+
+bool FrameExportServer::isSlotHeld(const uint32_t &slot) const
+{
+    for (const auto &client : m_clients)
+    {
+        if (client.heldSlots & (uint64_t(1) << slot))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+} // namespace star::windowing
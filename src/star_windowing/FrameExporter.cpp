@@ -0,0 +1,361 @@
+#include "star_windowing/FrameExporter.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__unix__)
+#include <unistd.h>
+#endif
+
+namespace star::windowing
+{
+namespace
+{
+constexpr auto MemoryHandleType = vk::ExternalMemoryHandleTypeFlagBits::eOpaqueFd;
+constexpr auto SemaphoreHandleType = vk::ExternalSemaphoreHandleTypeFlagBits::eOpaqueFd;
+constexpr auto ExportUsage =
+    vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eSampled;
+
+void CloseFd(int &fd)
+{
+#if defined(__unix__)
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+#endif
+    fd = -1;
+}
+
+vk::ImageSubresourceRange ColorRange()
+{
+    return vk::ImageSubresourceRange()
+        .setAspectMask(vk::ImageAspectFlagBits::eColor)
+        .setBaseMipLevel(0)
+        .setLevelCount(1)
+        .setBaseArrayLayer(0)
+        .setLayerCount(1);
+}
+} // namespace
+
+std::vector<const char *> FrameExporter::GetRequiredDeviceExtensions()
+{
+    return {VK_KHR_EXTERNAL_MEMORY_FD_EXTENSION_NAME, VK_KHR_EXTERNAL_SEMAPHORE_FD_EXTENSION_NAME};
+}
+
+void FrameExporter::prepRender(core::device::StarDevice &device, const vk::Extent2D &extent, const vk::Format &format,
+                               const uint8_t &numImages, const std::string &socketPath)
+{
+    assert(numImages > 0 && numImages <= 64 && "Export ring must hold between 1 and 64 images");
+
+    const vk::PhysicalDevice &physicalDevice = device.getPhysicalDevice();
+
+    // copies are tracked with a timeline semaphore, both by consumers and on the host when it can not be exported
+    const auto features = physicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features>()
+                              .get<vk::PhysicalDeviceVulkan12Features>();
+    if (!features.timelineSemaphore)
+    {
+        throw std::runtime_error("Frame export requires a device supporting the timelineSemaphore feature");
+    }
+
+    const auto externalFormatInfo = vk::PhysicalDeviceExternalImageFormatInfo().setHandleType(MemoryHandleType);
+    const auto imageSupport =
+        physicalDevice.getImageFormatProperties2<vk::ImageFormatProperties2, vk::ExternalImageFormatProperties>(
+            vk::PhysicalDeviceImageFormatInfo2()
+                .setPNext(&externalFormatInfo)
+                .setFormat(format)
+                .setType(vk::ImageType::e2D)
+                .setTiling(vk::ImageTiling::eOptimal)
+                .setUsage(ExportUsage));
+    if (!(imageSupport.get<vk::ExternalImageFormatProperties>().externalMemoryProperties.externalMemoryFeatures &
+          vk::ExternalMemoryFeatureFlagBits::eExportable))
+    {
+        throw std::runtime_error("Device can not export images of the swapchain format as opaque file descriptors");
+    }
+
+    auto *getMemoryFd =
+        reinterpret_cast<PFN_vkGetMemoryFdKHR>(device.getVulkanDevice().getProcAddr("vkGetMemoryFdKHR"));
+    if (getMemoryFd == nullptr)
+    {
+        throw std::runtime_error("vkGetMemoryFdKHR is not available, was VK_KHR_external_memory_fd enabled");
+    }
+
+    m_extent = extent;
+    m_slots.resize(numImages);
+    for (auto &slot : m_slots)
+    {
+        createSlot(device, slot, format, getMemoryFd);
+    }
+
+    createSemaphore(device);
+
+    const auto ids = physicalDevice.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceIDProperties>()
+                         .get<vk::PhysicalDeviceIDProperties>();
+    m_ringInfo = FrameExportRingInfo{};
+    m_ringInfo.numImages = numImages;
+    m_ringInfo.width = extent.width;
+    m_ringInfo.height = extent.height;
+    m_ringInfo.format = static_cast<uint32_t>(format);
+    m_ringInfo.allocationSize = device.getVulkanDevice().getImageMemoryRequirements(m_slots.front().image).size;
+    std::memcpy(m_ringInfo.deviceUUID, ids.deviceUUID.data(), sizeof(m_ringInfo.deviceUUID));
+    std::memcpy(m_ringInfo.driverUUID, ids.driverUUID.data(), sizeof(m_ringInfo.driverUUID));
+    m_ringInfo.semaphoreExported = m_semaphoreExported ? 1 : 0;
+
+    m_server.start(socketPath);
+}
+
+void FrameExporter::cleanupRender(core::device::StarDevice &device)
+{
+    m_server.stop();
+
+    for (auto &slot : m_slots)
+    {
+        CloseFd(slot.memoryFd);
+        device.getVulkanDevice().destroyImage(slot.image);
+        device.getVulkanDevice().freeMemory(slot.memory);
+    }
+    m_slots.clear();
+
+    CloseFd(m_semaphoreFd);
+    if (m_semaphore)
+    {
+        device.getVulkanDevice().destroySemaphore(m_semaphore);
+        m_semaphore = VK_NULL_HANDLE;
+    }
+}
+
+bool FrameExporter::beginFrame(core::device::StarDevice &device)
+{
+    m_server.acceptClients(m_ringInfo, getSharedFds());
+    m_server.collectReleases();
+    broadcastCompleted(device);
+
+    if (!m_server.hasClients())
+    {
+        return false;
+    }
+
+    // the oldest slot is the most likely to be free, skip the frame rather than wait when it is not
+    const uint64_t completedValue = device.getVulkanDevice().getSemaphoreCounterValue(m_semaphore);
+    const uint32_t candidate = (m_currentSlot + 1) % static_cast<uint32_t>(m_slots.size());
+    const Slot &slot = m_slots[candidate];
+    if (m_server.isSlotHeld(candidate) || slot.pendingBroadcast || slot.timelineValue > completedValue)
+    {
+        return false;
+    }
+
+    m_currentSlot = candidate;
+    m_slots[m_currentSlot].timelineValue = m_nextTimelineValue++;
+    return true;
+}
+
+void FrameExporter::recordCopy(vk::CommandBuffer &commandBuffer, const vk::Image &source,
+                               const vk::Extent2D &sourceExtent, const vk::ImageLayout &sourceLayout) const
+{
+    const vk::Image &target = m_slots[m_currentSlot].image;
+
+    std::array<vk::ImageMemoryBarrier2, 2> toTransfer{
+        vk::ImageMemoryBarrier2()
+            .setOldLayout(sourceLayout)
+            .setNewLayout(vk::ImageLayout::eTransferSrcOptimal)
+            .setSrcStageMask(vk::PipelineStageFlagBits2::eColorAttachmentOutput)
+            .setSrcAccessMask(vk::AccessFlagBits2::eColorAttachmentWrite)
+            .setDstStageMask(vk::PipelineStageFlagBits2::eBlit)
+            .setDstAccessMask(vk::AccessFlagBits2::eTransferRead)
+            .setSrcQueueFamilyIndex(vk::QueueFamilyIgnored)
+            .setDstQueueFamilyIndex(vk::QueueFamilyIgnored)
+            .setImage(source)
+            .setSubresourceRange(ColorRange()),
+        // previous contents were released by every consumer
+        vk::ImageMemoryBarrier2()
+            .setOldLayout(vk::ImageLayout::eUndefined)
+            .setNewLayout(vk::ImageLayout::eTransferDstOptimal)
+            .setSrcStageMask(vk::PipelineStageFlagBits2::eTopOfPipe)
+            .setSrcAccessMask(vk::AccessFlagBits2::eNone)
+            .setDstStageMask(vk::PipelineStageFlagBits2::eBlit)
+            .setDstAccessMask(vk::AccessFlagBits2::eTransferWrite)
+            .setSrcQueueFamilyIndex(vk::QueueFamilyIgnored)
+            .setDstQueueFamilyIndex(vk::QueueFamilyIgnored)
+            .setImage(target)
+            .setSubresourceRange(ColorRange())};
+    commandBuffer.pipelineBarrier2(vk::DependencyInfo()
+                                       .setImageMemoryBarrierCount(static_cast<uint32_t>(toTransfer.size()))
+                                       .setPImageMemoryBarriers(toTransfer.data()));
+
+    // a blit rather than a copy keeps the ring size fixed for consumers when the window is resized
+    const auto layers = vk::ImageSubresourceLayers()
+                            .setAspectMask(vk::ImageAspectFlagBits::eColor)
+                            .setMipLevel(0)
+                            .setBaseArrayLayer(0)
+                            .setLayerCount(1);
+    const auto region =
+        vk::ImageBlit()
+            .setSrcSubresource(layers)
+            .setSrcOffsets({vk::Offset3D(0, 0, 0), vk::Offset3D(static_cast<int32_t>(sourceExtent.width),
+                                                                static_cast<int32_t>(sourceExtent.height), 1)})
+            .setDstSubresource(layers)
+            .setDstOffsets({vk::Offset3D(0, 0, 0), vk::Offset3D(static_cast<int32_t>(m_extent.width),
+                                                                static_cast<int32_t>(m_extent.height), 1)});
+    commandBuffer.blitImage(source, vk::ImageLayout::eTransferSrcOptimal, target,
+                            vk::ImageLayout::eTransferDstOptimal, 1, &region, vk::Filter::eLinear);
+
+    std::array<vk::ImageMemoryBarrier2, 2> fromTransfer{
+        vk::ImageMemoryBarrier2()
+            .setOldLayout(vk::ImageLayout::eTransferSrcOptimal)
+            .setNewLayout(sourceLayout)
+            .setSrcStageMask(vk::PipelineStageFlagBits2::eBlit)
+            .setSrcAccessMask(vk::AccessFlagBits2::eTransferRead)
+            .setDstStageMask(vk::PipelineStageFlagBits2::eBottomOfPipe)
+            .setDstAccessMask(vk::AccessFlagBits2::eNone)
+            .setSrcQueueFamilyIndex(vk::QueueFamilyIgnored)
+            .setDstQueueFamilyIndex(vk::QueueFamilyIgnored)
+            .setImage(source)
+            .setSubresourceRange(ColorRange()),
+        // consumers import the image expecting general layout
+        vk::ImageMemoryBarrier2()
+            .setOldLayout(vk::ImageLayout::eTransferDstOptimal)
+            .setNewLayout(vk::ImageLayout::eGeneral)
+            .setSrcStageMask(vk::PipelineStageFlagBits2::eBlit)
+            .setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite)
+            .setDstStageMask(vk::PipelineStageFlagBits2::eBottomOfPipe)
+            .setDstAccessMask(vk::AccessFlagBits2::eNone)
+            .setSrcQueueFamilyIndex(vk::QueueFamilyIgnored)
+            .setDstQueueFamilyIndex(vk::QueueFamilyIgnored)
+            .setImage(target)
+            .setSubresourceRange(ColorRange())};
+    commandBuffer.pipelineBarrier2(vk::DependencyInfo()
+                                       .setImageMemoryBarrierCount(static_cast<uint32_t>(fromTransfer.size()))
+                                       .setPImageMemoryBarriers(fromTransfer.data()));
+}
+
+void FrameExporter::endFrame()
+{
+    Slot &slot = m_slots[m_currentSlot];
+    if (m_semaphoreExported)
+    {
+        // consumers wait on the semaphore themselves, no need to hold the frame back
+        m_server.broadcast(FrameExportMessage{.slot = m_currentSlot, .timelineValue = slot.timelineValue});
+        return;
+    }
+
+    slot.pendingBroadcast = true;
+}
+
+void FrameExporter::createSlot(core::device::StarDevice &device, Slot &slot, const vk::Format &format,
+                               PFN_vkGetMemoryFdKHR getMemoryFd) const
+{
+    const auto externalInfo = vk::ExternalMemoryImageCreateInfo().setHandleTypes(MemoryHandleType);
+    slot.image = device.getVulkanDevice().createImage(vk::ImageCreateInfo()
+                                                          .setPNext(&externalInfo)
+                                                          .setImageType(vk::ImageType::e2D)
+                                                          .setFormat(format)
+                                                          .setExtent(vk::Extent3D(m_extent, 1))
+                                                          .setMipLevels(1)
+                                                          .setArrayLayers(1)
+                                                          .setSamples(vk::SampleCountFlagBits::e1)
+                                                          .setTiling(vk::ImageTiling::eOptimal)
+                                                          .setUsage(ExportUsage)
+                                                          .setSharingMode(vk::SharingMode::eExclusive)
+                                                          .setInitialLayout(vk::ImageLayout::eUndefined));
+
+    const vk::MemoryRequirements requirements = device.getVulkanDevice().getImageMemoryRequirements(slot.image);
+
+    // dedicated allocations are what importers expect for exported images
+    const auto dedicatedInfo = vk::MemoryDedicatedAllocateInfo().setImage(slot.image);
+    const auto exportInfo = vk::ExportMemoryAllocateInfo().setHandleTypes(MemoryHandleType).setPNext(&dedicatedInfo);
+    slot.memory = device.getVulkanDevice().allocateMemory(
+        vk::MemoryAllocateInfo()
+            .setPNext(&exportInfo)
+            .setAllocationSize(requirements.size)
+            .setMemoryTypeIndex(FindDeviceLocalMemoryType(device, requirements.memoryTypeBits)));
+    device.getVulkanDevice().bindImageMemory(slot.image, slot.memory, 0);
+
+    const VkMemoryGetFdInfoKHR getFdInfo{.sType = VK_STRUCTURE_TYPE_MEMORY_GET_FD_INFO_KHR,
+                                         .memory = slot.memory,
+                                         .handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT};
+    if (getMemoryFd(device.getVulkanDevice(), &getFdInfo, &slot.memoryFd) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to export frame export image memory");
+    }
+}
+
+void FrameExporter::createSemaphore(core::device::StarDevice &device)
+{
+    const auto typeInfo = vk::SemaphoreTypeCreateInfo().setSemaphoreType(vk::SemaphoreType::eTimeline);
+
+    const auto support = device.getPhysicalDevice().getExternalSemaphoreProperties(
+        vk::PhysicalDeviceExternalSemaphoreInfo().setPNext(&typeInfo).setHandleType(SemaphoreHandleType));
+    auto *getSemaphoreFd =
+        reinterpret_cast<PFN_vkGetSemaphoreFdKHR>(device.getVulkanDevice().getProcAddr("vkGetSemaphoreFdKHR"));
+    m_semaphoreExported = getSemaphoreFd != nullptr &&
+                          (support.externalSemaphoreFeatures & vk::ExternalSemaphoreFeatureFlagBits::eExportable);
+
+    // without export support the semaphore is still used to find out on the host when copies are done
+    const auto exportInfo = vk::ExportSemaphoreCreateInfo().setHandleTypes(SemaphoreHandleType).setPNext(&typeInfo);
+    m_semaphore = device.getVulkanDevice().createSemaphore(
+        vk::SemaphoreCreateInfo().setPNext(m_semaphoreExported ? static_cast<const void *>(&exportInfo) : &typeInfo));
+
+    if (m_semaphoreExported)
+    {
+        const VkSemaphoreGetFdInfoKHR getFdInfo{.sType = VK_STRUCTURE_TYPE_SEMAPHORE_GET_FD_INFO_KHR,
+                                                .semaphore = m_semaphore,
+                                                .handleType = VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_OPAQUE_FD_BIT};
+        if (getSemaphoreFd(device.getVulkanDevice(), &getFdInfo, &m_semaphoreFd) != VK_SUCCESS)
+        {
+            m_semaphoreExported = false;
+        }
+    }
+}
+
+uint32_t FrameExporter::FindDeviceLocalMemoryType(core::device::StarDevice &device, const uint32_t &typeBits)
+{
+    const auto properties = device.getPhysicalDevice().getMemoryProperties();
+    for (uint32_t i = 0; i < properties.memoryTypeCount; i++)
+    {
+        if ((typeBits & (1u << i)) &&
+            (properties.memoryTypes[i].propertyFlags & vk::MemoryPropertyFlagBits::eDeviceLocal))
+        {
+            return i;
+        }
+    }
+
+    throw std::runtime_error("Failed to find a device local memory type for frame export images");
+}
+
+void FrameExporter::broadcastCompleted(core::device::StarDevice &device)
+{
+    if (m_semaphoreExported)
+    {
+        return;
+    }
+
+    const uint64_t completedValue = device.getVulkanDevice().getSemaphoreCounterValue(m_semaphore);
+    for (uint32_t i = 0; i < m_slots.size(); i++)
+    {
+        Slot &slot = m_slots[i];
+        if (slot.pendingBroadcast && slot.timelineValue <= completedValue)
+        {
+            slot.pendingBroadcast = false;
+            m_server.broadcast(FrameExportMessage{.slot = i, .timelineValue = slot.timelineValue});
+        }
+    }
+}
+
+std::vector<int> FrameExporter::getSharedFds() const
+{
+    std::vector<int> fds;
+    fds.reserve(m_slots.size() + 1);
+    for (const auto &slot : m_slots)
+    {
+        fds.push_back(slot.memoryFd);
+    }
+    if (m_semaphoreExported)
+    {
+        fds.push_back(m_semaphoreFd);
+    }
+
+    return fds;
+}
+} // namespace star::windowing
@@ -0,0 +1,43 @@
+#include "star_windowing/FrameRateLimiter.hpp"
+
+#include <thread>
+
+namespace star::windowing
+{
+void FrameRateLimiter::setMaxFramesPerSecond(const double &maxFramesPerSecond)
+{
+    m_framePeriod = maxFramesPerSecond > 0.0 ? std::chrono::duration_cast<Clock::duration>(
+                                                   std::chrono::duration<double>(1.0 / maxFramesPerSecond))
+                                             : Clock::duration{0};
+    m_nextFrame = Clock::time_point{};
+}
+
+void FrameRateLimiter::waitForNextFrame()
+{
+    if (!isEnabled())
+    {
+        return;
+    }
+
+    auto now = Clock::now();
+    if (m_nextFrame == Clock::time_point{} || now - m_nextFrame > m_framePeriod)
+    {
+        // first frame, or too far behind to catch up. Start the schedule over instead of running frames back to back.
+        m_nextFrame = now + m_framePeriod;
+        return;
+    }
+
+    if (m_nextFrame - now > m_spinThreshold)
+    {
+        std::this_thread::sleep_for(m_nextFrame - now - m_spinThreshold);
+    }
+
+    while (Clock::now() < m_nextFrame)
+    {
+        std::this_thread::yield();
+    }
+
+    // schedule from the deadline rather than from now so overshoot does not accumulate
+    m_nextFrame += m_framePeriod;
+}
+} // namespace star::windowing
@@ -0,0 +1,60 @@
+#include "star_windowing/GamepadSnapshot.hpp"
+
+#include <algorithm>
+
+namespace star::windowing
+{
+void GamepadSnapshot::poll()
+{
+    connectedMask = 0;
+    gamepadMask = 0;
+
+    for (int device = 0; device < static_cast<int>(MaxDevices); device++)
+    {
+        if (!glfwJoystickPresent(device))
+        {
+            for (size_t a = 0; a < NumAxes; a++)
+            {
+                axes[a][device] = 0.0f;
+            }
+            for (size_t b = 0; b < NumButtons; b++)
+            {
+                buttons[b][device] = GLFW_RELEASE;
+            }
+            continue;
+        }
+
+        connectedMask |= 1u << device;
+
+        GLFWgamepadstate state;
+        if (glfwJoystickIsGamepad(device) && glfwGetGamepadState(device, &state))
+        {
+            gamepadMask |= 1u << device;
+
+            for (size_t a = 0; a < NumAxes; a++)
+            {
+                axes[a][device] = state.axes[a];
+            }
+            for (size_t b = 0; b < NumButtons; b++)
+            {
+                buttons[b][device] = state.buttons[b];
+            }
+            continue;
+        }
+
+        // no standard mapping, expose the raw controls which fit
+        int axisCount = 0, buttonCount = 0;
+        const float *rawAxes = glfwGetJoystickAxes(device, &axisCount);
+        const unsigned char *rawButtons = glfwGetJoystickButtons(device, &buttonCount);
+
+        for (size_t a = 0; a < NumAxes; a++)
+        {
+            axes[a][device] = a < static_cast<size_t>(std::max(axisCount, 0)) ? rawAxes[a] : 0.0f;
+        }
+        for (size_t b = 0; b < NumButtons; b++)
+        {
+            buttons[b][device] = b < static_cast<size_t>(std::max(buttonCount, 0)) ? rawButtons[b] : GLFW_RELEASE;
+        }
+    }
+}
+} // namespace star::windowing
@@ -0,0 +1,199 @@
+#include "star_windowing/InputBus.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace star::windowing
+{
+uint32_t InputBus::subscribe(const uint32_t &typeMask, Callback callback, void *context)
+{
+    assert(callback != nullptr);
+
+    const Listener listener{callback, context, typeMask, m_nextToken++};
+    if (m_emitDepth > 0)
+    {
+        m_pendingSubscriptions.push_back(PendingSubscription{listener, false, InputFilter{}});
+    }
+    else
+    {
+        addListener(listener, false, InputFilter{});
+    }
+
+    return listener.token;
+}
+
+uint32_t InputBus::subscribe(const InputFilter &filter, const uint32_t &typeMask, Callback callback, void *context)
+{
+    assert(filter.isValid() && callback != nullptr);
+
+    const Listener listener{callback, context, typeMask, m_nextToken++};
+    if (m_emitDepth > 0)
+    {
+        m_pendingSubscriptions.push_back(PendingSubscription{listener, true, filter});
+    }
+    else
+    {
+        addListener(listener, true, filter);
+    }
+
+    return listener.token;
+}
+
+void InputBus::unsubscribe(const uint32_t &token)
+{
+    if (m_emitDepth > 0)
+    {
+        // the listener may be in the middle of being called, it is skipped from here on and removed afterwards
+        markListenerRemoved(token);
+        m_pendingSubscriptions.erase(std::remove_if(m_pendingSubscriptions.begin(), m_pendingSubscriptions.end(),
+                                                    [&token](const PendingSubscription &pending) {
+                                                        return pending.listener.token == token;
+                                                    }),
+                                     m_pendingSubscriptions.end());
+        return;
+    }
+
+    removeListener(token);
+}
+
+void InputBus::emit(const InputRecord &record)
+{
+    m_emitDepth++;
+
+    dispatch(m_typeListeners[static_cast<size_t>(record.type)], record);
+
+    switch (record.type)
+    {
+    case InputRecord::Type::key_press:
+    case InputRecord::Type::key_release:
+        if (IsValidInputCode(Input_Source::key, record.key.key))
+        {
+            dispatch(m_codeListeners[GetInputCodeIndex(Input_Source::key, record.key.key)], record);
+        }
+        break;
+    case InputRecord::Type::mouse_button:
+        if (IsValidInputCode(Input_Source::mouse_button, record.mouseButton.button))
+        {
+            dispatch(m_codeListeners[GetInputCodeIndex(Input_Source::mouse_button, record.mouseButton.button)],
+                     record);
+        }
+        break;
+    default:
+        break;
+    }
+
+    m_emitDepth--;
+    if (m_emitDepth == 0)
+    {
+        applyPendingChanges();
+    }
+}
+
+void InputBus::addListener(const Listener &listener, const bool &isFiltered, const InputFilter &filter)
+{
+    if (isFiltered)
+    {
+        for (int code = filter.first; code <= filter.last; code++)
+        {
+            m_codeListeners[GetInputCodeIndex(filter.source, code)].push_back(listener);
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < InputRecord::NumTypes; i++)
+    {
+        if (listener.typeMask & InputRecord::TypeBit(static_cast<InputRecord::Type>(i)))
+        {
+            m_typeListeners[i].push_back(listener);
+        }
+    }
+}
+
+void InputBus::removeListener(const uint32_t &token)
+{
+    const auto removeToken = [&token](std::vector<Listener> &listeners) {
+        listeners.erase(std::remove_if(listeners.begin(), listeners.end(),
+                                       [&token](const Listener &listener) { return listener.token == token; }),
+                        listeners.end());
+    };
+
+    for (auto &listeners : m_typeListeners)
+    {
+        removeToken(listeners);
+    }
+    for (auto &listeners : m_codeListeners)
+    {
+        removeToken(listeners);
+    }
+}
+
+void InputBus::markListenerRemoved(const uint32_t &token)
+{
+    const auto markToken = [&token](std::vector<Listener> &listeners) {
+        for (auto &listener : listeners)
+        {
+            if (listener.token == token)
+            {
+                listener.isRemoved = true;
+            }
+        }
+    };
+
+    for (auto &listeners : m_typeListeners)
+    {
+        markToken(listeners);
+    }
+    for (auto &listeners : m_codeListeners)
+    {
+        markToken(listeners);
+    }
+    m_hasRemovedListeners = true;
+}
+
+void InputBus::eraseRemovedListeners()
+{
+    const auto eraseRemoved = [](std::vector<Listener> &listeners) {
+        listeners.erase(std::remove_if(listeners.begin(), listeners.end(),
+                                       [](const Listener &listener) { return listener.isRemoved; }),
+                        listeners.end());
+    };
+
+    for (auto &listeners : m_typeListeners)
+    {
+        eraseRemoved(listeners);
+    }
+    for (auto &listeners : m_codeListeners)
+    {
+        eraseRemoved(listeners);
+    }
+    m_hasRemovedListeners = false;
+}
+
+void InputBus::applyPendingChanges()
+{
+    if (m_hasRemovedListeners)
+    {
+        eraseRemovedListeners();
+    }
+
+    for (const auto &pending : m_pendingSubscriptions)
+    {
+        addListener(pending.listener, pending.isFiltered, pending.filter);
+    }
+    m_pendingSubscriptions.clear();
+}
+
+void InputBus::dispatch(const std::vector<Listener> &listeners, const InputRecord &record) const
+{
+    const uint32_t typeBit = InputRecord::TypeBit(record.type);
+    for (const auto &listener : listeners)
+    {
+        if (!(listener.typeMask & typeBit) || listener.isRemoved)
+        {
+            continue;
+        }
+
+        listener.callback(listener.context, record);
+    }
+}
+} // namespace star::windowing
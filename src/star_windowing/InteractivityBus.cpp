@@ -1,52 +1,270 @@
 #include "star_windowing/InteractivityBus.hpp"
 
+#include <star_windowing/RenderThread.hpp>
 #include <star_windowing/event/KeyPress.hpp>
 #include <star_windowing/event/KeyRelease.hpp>
 #include <star_windowing/event/MouseButton.hpp>
+#include <star_windowing/event/MouseDelta.hpp>
 #include <star_windowing/event/MouseMovement.hpp>
+#include <star_windowing/event/Scroll.hpp>
 
+#include <algorithm>
 #include <cassert>
 
 namespace star::windowing
 {
 common::EventBus *InteractivityBus::m_deviceEventBus = nullptr;
+bool InteractivityBus::m_forwardToDeviceBus = false;
+bool InteractivityBus::m_useCrossThreadQueue = false;
+bool InteractivityBus::m_deferDispatch = false;
+std::vector<InputRecord> InteractivityBus::m_deferredInput;
+SpscQueue<InputRecord, 1024> InteractivityBus::m_crossThreadQueue;
+bool InteractivityBus::m_hasLastCapturedCursor = false;
+double InteractivityBus::m_lastCapturedCursorX = 0.0;
+double InteractivityBus::m_lastCapturedCursorY = 0.0;
+double InteractivityBus::m_accumulatedDeltaX = 0.0;
+double InteractivityBus::m_accumulatedDeltaY = 0.0;
+double InteractivityBus::m_accumulatedScrollX = 0.0;
+double InteractivityBus::m_accumulatedScrollY = 0.0;
+GamepadSnapshot InteractivityBus::m_gamepads;
+std::vector<ActionMap *> InteractivityBus::m_actionMaps;
+InputBus InteractivityBus::m_inputBus;
+LatestValue<GamepadSnapshot> InteractivityBus::m_crossThreadGamepads;
 
 void InteractivityBus::Init(star::common::EventBus *deviceEventBus, WindowingContext *winContext)
 {
     assert(deviceEventBus != nullptr && winContext != nullptr);
 
     m_deviceEventBus = deviceEventBus;
+    m_forwardToDeviceBus = winContext->forwardInputToDeviceBus;
+    m_useCrossThreadQueue = winContext->threadingMode == Threading_Mode::dedicated_render_thread;
+    m_deferDispatch = winContext->inputDispatchMode == Input_Dispatch_Mode::deferred;
 
-    glfwSetCursorPosCallback(winContext->window.getGLFWWindow(), InteractivityBus::GlfwCallbackMouseMovement);
-    glfwSetKeyCallback(winContext->window.getGLFWWindow(), InteractivityBus::GlfwKeyCallback);
-    glfwSetMouseButtonCallback(winContext->window.getGLFWWindow(), InteractivityBus::GlfwCallbackMouseButton);
+    if (m_deferDispatch)
+    {
+        // generous for a single frame of input, the storage is kept between frames
+        m_deferredInput.reserve(256);
+    }
+
+    RenderThread::RunOnMainThread([winContext]() {
+        glfwSetCursorPosCallback(winContext->window.getGLFWWindow(), InteractivityBus::GlfwCallbackMouseMovement);
+        glfwSetKeyCallback(winContext->window.getGLFWWindow(), InteractivityBus::GlfwKeyCallback);
+        glfwSetMouseButtonCallback(winContext->window.getGLFWWindow(), InteractivityBus::GlfwCallbackMouseButton);
+        glfwSetScrollCallback(winContext->window.getGLFWWindow(), InteractivityBus::GlfwCallbackScroll);
+    });
 }
 
 void InteractivityBus::GlfwCallbackMouseMovement(GLFWwindow *window, double xpos, double ypos)
 {
-    assert(m_deviceEventBus != nullptr);
+    const auto *starWindow = static_cast<const StarWindow *>(glfwGetWindowUserPointer(window));
+    if (starWindow == nullptr || !starWindow->isCursorCaptured())
+    {
+        m_hasLastCapturedCursor = false;
+        Submit(InputRecord::MouseMovement(xpos, ypos));
+        return;
+    }
 
-    m_deviceEventBus->emit(event::MouseMovement{xpos, ypos});
+    // while captured GLFW reports a virtual, unbounded position. Only the change is meaningful.
+    if (m_hasLastCapturedCursor)
+    {
+        Submit(InputRecord::MouseDelta(xpos - m_lastCapturedCursorX, ypos - m_lastCapturedCursorY));
+    }
+
+    m_lastCapturedCursorX = xpos;
+    m_lastCapturedCursorY = ypos;
+    m_hasLastCapturedCursor = true;
 }
 
 void InteractivityBus::GlfwCallbackMouseButton(GLFWwindow *window, int button, int action, int mods)
 {
-    assert(m_deviceEventBus != nullptr);
-
-    m_deviceEventBus->emit(event::MouseButton{button, action, mods});
+    Submit(InputRecord::MouseButton(button, action, mods));
 }
 
 void InteractivityBus::GlfwKeyCallback(GLFWwindow *window, int key, int scancode, int action, int mods)
 {
-    assert(m_deviceEventBus != nullptr);
-
     if (action == GLFW_PRESS)
     {
-        m_deviceEventBus->emit(event::KeyPress{key, scancode, mods});
+        Submit(InputRecord::KeyPress(key, scancode, mods));
     }
     else if (action == GLFW_RELEASE)
     {
-        m_deviceEventBus->emit(event::KeyRelease{key, scancode, mods});
+        Submit(InputRecord::KeyRelease(key, scancode, mods));
+    }
+}
+
+void InteractivityBus::GlfwCallbackScroll(GLFWwindow *window, double xoffset, double yoffset)
+{
+    Submit(InputRecord::Scroll(xoffset, yoffset));
+}
+
+void InteractivityBus::DispatchQueuedInput()
+{
+    InputRecord record;
+    while (m_crossThreadQueue.tryPop(record))
+    {
+        if (m_deferDispatch)
+        {
+            m_deferredInput.push_back(record);
+        }
+        else
+        {
+            Emit(record);
+        }
+    }
+}
+
+void InteractivityBus::BeginInputFrame()
+{
+    for (auto *actionMap : m_actionMaps)
+    {
+        actionMap->beginFrame();
+    }
+}
+
+void InteractivityBus::RegisterActionMap(ActionMap &actionMap)
+{
+    if (std::find(m_actionMaps.begin(), m_actionMaps.end(), &actionMap) == m_actionMaps.end())
+    {
+        m_actionMaps.push_back(&actionMap);
+    }
+}
+
+void InteractivityBus::UnregisterActionMap(ActionMap &actionMap)
+{
+    m_actionMaps.erase(std::remove(m_actionMaps.begin(), m_actionMaps.end(), &actionMap), m_actionMaps.end());
+}
+
+void InteractivityBus::EndInputFrame()
+{
+    for (const auto &record : m_deferredInput)
+    {
+        Emit(record);
+    }
+    m_deferredInput.clear();
+
+    if (m_accumulatedDeltaX != 0.0 || m_accumulatedDeltaY != 0.0)
+    {
+        Publish(InputRecord::MouseDelta(m_accumulatedDeltaX, m_accumulatedDeltaY));
+
+        m_accumulatedDeltaX = 0.0;
+        m_accumulatedDeltaY = 0.0;
+    }
+
+    if (m_accumulatedScrollX != 0.0 || m_accumulatedScrollY != 0.0)
+    {
+        Publish(InputRecord::Scroll(m_accumulatedScrollX, m_accumulatedScrollY));
+
+        m_accumulatedScrollX = 0.0;
+        m_accumulatedScrollY = 0.0;
+    }
+
+    if (m_useCrossThreadQueue)
+    {
+        // only the most recent snapshot matters, the previous one is kept when nothing new was polled
+        m_crossThreadGamepads.tryTake(m_gamepads);
+    }
+    else
+    {
+        m_gamepads.poll();
+    }
+}
+
+void InteractivityBus::PollGamepadsForRenderThread()
+{
+    GamepadSnapshot snapshot = GamepadSnapshot();
+    snapshot.poll();
+
+    m_crossThreadGamepads.publish(snapshot);
+}
+
+void InteractivityBus::Submit(const InputRecord &record)
+{
+    if (!m_useCrossThreadQueue)
+    {
+        if (m_deferDispatch)
+        {
+            m_deferredInput.push_back(record);
+        }
+        else
+        {
+            Emit(record);
+        }
+        return;
+    }
+
+    // if the render thread has fallen far behind, drop the input rather than stall the GLFW thread
+    m_crossThreadQueue.tryPush(record);
+}
+
+void InteractivityBus::Emit(const InputRecord &record)
+{
+    switch (record.type)
+    {
+    case InputRecord::Type::key_press:
+    case InputRecord::Type::key_release:
+        for (auto *actionMap : m_actionMaps)
+        {
+            actionMap->processInput(Input_Source::key, record.key.key, record.type == InputRecord::Type::key_press);
+        }
+        Publish(record);
+        break;
+    case InputRecord::Type::mouse_button:
+        for (auto *actionMap : m_actionMaps)
+        {
+            actionMap->processInput(Input_Source::mouse_button, record.mouseButton.button,
+                                    record.mouseButton.action == GLFW_PRESS);
+        }
+        Publish(record);
+        break;
+    case InputRecord::Type::mouse_movement:
+        Publish(record);
+        break;
+    case InputRecord::Type::mouse_delta:
+        m_accumulatedDeltaX += record.cursor.xpos;
+        m_accumulatedDeltaY += record.cursor.ypos;
+        break;
+    case InputRecord::Type::scroll:
+        m_accumulatedScrollX += record.cursor.xpos;
+        m_accumulatedScrollY += record.cursor.ypos;
+        break;
+    }
+}
+
+void InteractivityBus::Publish(const InputRecord &record)
+{
+    m_inputBus.emit(record);
+
+    if (m_forwardToDeviceBus)
+    {
+        ForwardToDeviceBus(record);
+    }
+}
+
+void InteractivityBus::ForwardToDeviceBus(const InputRecord &record)
+{
+    assert(m_deviceEventBus != nullptr);
+
+    switch (record.type)
+    {
+    case InputRecord::Type::key_press:
+        m_deviceEventBus->emit(event::KeyPress{record.key.key, record.key.scancode, record.key.mods});
+        break;
+    case InputRecord::Type::key_release:
+        m_deviceEventBus->emit(event::KeyRelease{record.key.key, record.key.scancode, record.key.mods});
+        break;
+    case InputRecord::Type::mouse_button:
+        m_deviceEventBus->emit(
+            event::MouseButton{record.mouseButton.button, record.mouseButton.action, record.mouseButton.mods});
+        break;
+    case InputRecord::Type::mouse_movement:
+        m_deviceEventBus->emit(event::MouseMovement{record.cursor.xpos, record.cursor.ypos});
+        break;
+    case InputRecord::Type::mouse_delta:
+        m_deviceEventBus->emit(event::MouseDelta{record.cursor.xpos, record.cursor.ypos});
+        break;
+    case InputRecord::Type::scroll:
+        m_deviceEventBus->emit(event::Scroll{record.cursor.xpos, record.cursor.ypos});
+        break;
     }
 }
-} // namespace star::windowing
\ No newline at end of file
+} // namespace star::windowing
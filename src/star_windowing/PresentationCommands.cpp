@@ -62,6 +62,21 @@ void PresentationCommands::submitPresentation(core::device::StarDevice &device,
 {
     assert(m_recordDeps != nullptr);
 
+    if (!m_recordDeps->presentImage)
+    {
+        const vk::PipelineStageFlags waitStage = vk::PipelineStageFlagBits::eAllCommands;
+        const auto submitInfo = vk::SubmitInfo()
+                                    .setWaitSemaphoreCount(1)
+                                    .setPWaitSemaphores(&finalDoneSemaphore)
+                                    .setPWaitDstStageMask(&waitStage);
+        auto &queue = device.getDefaultQueue(star::Queue_Type::Tpresent).getVulkanQueue();
+        if (queue.submit(1, &submitInfo, VK_NULL_HANDLE) != vk::Result::eSuccess)
+        {
+            throw std::runtime_error("Failed to consume the done semaphore of a skipped frame");
+        }
+        return;
+    }
+
     auto presentInfo = vk::PresentInfoKHR()
                            .setWaitSemaphoreCount(1)
                            .setPWaitSemaphores(&finalDoneSemaphore)
@@ -69,21 +84,32 @@ void PresentationCommands::submitPresentation(core::device::StarDevice &device,
                            .setSwapchainCount(1)
                            .setPSwapchains(m_swapchain);
 
-    const auto presentResult =
-        device.getDefaultQueue(star::Queue_Type::Tpresent).getVulkanQueue().presentKHR(presentInfo);
+    // VK_KHR_incremental_present, lets the compositor copy only what changed
+    const auto region = vk::PresentRegionKHR()
+                            .setRectangleCount(static_cast<uint32_t>(m_recordDeps->presentRegions.size()))
+                            .setPRectangles(m_recordDeps->presentRegions.data());
+    const auto presentRegions = vk::PresentRegionsKHR().setSwapchainCount(1).setPRegions(&region);
+    if (!m_recordDeps->presentRegions.empty())
+    {
+        presentInfo.setPNext(&presentRegions);
+    }
 
-    if (presentResult != vk::Result::eSuccess)
+    vk::Result presentResult = vk::Result::eSuccess;
+    try
     {
-        throw std::runtime_error("failed");
+        presentResult = device.getDefaultQueue(star::Queue_Type::Tpresent).getVulkanQueue().presentKHR(presentInfo);
+    }
+    catch (const vk::OutOfDateKHRError &)
+    {
+        // the swapchain controller rebuilds when the next acquire reports the same
+        presentResult = vk::Result::eErrorOutOfDateKHR;
     }
 
-    // todo eventually need to handle resizing
-    //  if (presentResult == vk::Result::eErrorOutOfDateKHR || presentResult == vk::Result::eSuboptimalKHR ||
-    //      frameBufferResized)
-    //  {
-    //      frameBufferResized = false;
-    //      recreateSwapChain();
-    //  }
+    if (presentResult != vk::Result::eSuccess && presentResult != vk::Result::eSuboptimalKHR &&
+        presentResult != vk::Result::eErrorOutOfDateKHR)
+    {
+        throw std::runtime_error("failed");
+    }
 }
 
 void PresentationCommands::notificationFromEventBusHandleDelete(const Handle &noLongerNeededSubscriberHandle)
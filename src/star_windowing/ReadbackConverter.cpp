@@ -0,0 +1,403 @@
+#include "star_windowing/ReadbackConverter.hpp"
+
+#include <array>
+#include <cassert>
+#include <stdexcept>
+
+namespace star::windowing
+{
+namespace
+{
+#ifdef STAR_WINDOWING_GPU_READBACK
+constexpr uint32_t ReadbackYuvSpirv[] = {
+#include "star_windowing/shaders/ReadbackYuv.comp.inc"
+};
+constexpr bool HasReadbackShader = true;
+#else
+// built without glslc, see STARLIGHT_WINDOWING_GPU_READBACK
+constexpr uint32_t ReadbackYuvSpirv[] = {0};
+constexpr bool HasReadbackShader = false;
+#endif
+
+// matches local_size in ReadbackYuv.comp, with each invocation covering 8x2 pixels
+constexpr uint32_t WorkgroupSize = 8;
+constexpr uint32_t BlockWidth = 8, BlockHeight = 2;
+
+vk::ImageSubresourceRange ColorRange()
+{
+    return vk::ImageSubresourceRange()
+        .setAspectMask(vk::ImageAspectFlagBits::eColor)
+        .setBaseMipLevel(0)
+        .setLevelCount(1)
+        .setBaseArrayLayer(0)
+        .setLayerCount(1);
+}
+} // namespace
+
+void ReadbackConverter::prepRender(core::device::StarDevice &device, const vk::Extent2D &outputExtent,
+                                   const Readback_Format &format, const vk::Format &sourceFormat,
+                                   const uint8_t &numFramesInFlight)
+{
+    assert(format != Readback_Format::disabled && numFramesInFlight > 0);
+
+    if (!HasReadbackShader)
+    {
+        throw std::runtime_error("Readback is unavailable, the library was built without its shaders");
+    }
+
+    m_extent = vk::Extent2D(outputExtent.width - outputExtent.width % BlockWidth,
+                            outputExtent.height - outputExtent.height % BlockHeight);
+    if (m_extent.width == 0 || m_extent.height == 0)
+    {
+        throw std::runtime_error("Readback extent must be at least 8x2 pixels");
+    }
+
+    m_format = format;
+    // 8 bits of luma per pixel and a quarter of that for each chroma channel
+    m_readbackSize = vk::DeviceSize(m_extent.width) * m_extent.height * 3 / 2;
+    // the blit decodes srgb sources to linear values, which need to be encoded again for YUV
+    m_encodeSrgb = IsSrgbFormat(sourceFormat);
+
+    createPipeline(device);
+
+    m_frames.resize(numFramesInFlight);
+    for (auto &frame : m_frames)
+    {
+        createFrameResources(device, frame);
+    }
+}
+
+void ReadbackConverter::cleanupRender(core::device::StarDevice &device)
+{
+    const vk::Device &vkDevice = device.getVulkanDevice();
+
+    for (auto &frame : m_frames)
+    {
+        if (frame.mapped != nullptr)
+        {
+            vkDevice.unmapMemory(frame.bufferMemory);
+        }
+        vkDevice.destroyBuffer(frame.buffer);
+        vkDevice.freeMemory(frame.bufferMemory);
+        vkDevice.destroyImageView(frame.imageView);
+        vkDevice.destroyImage(frame.image);
+        vkDevice.freeMemory(frame.imageMemory);
+    }
+    m_frames.clear();
+
+    // descriptor sets are freed along with the pool
+    vkDevice.destroyDescriptorPool(m_descriptorPool);
+    vkDevice.destroyPipeline(m_pipeline);
+    vkDevice.destroyPipelineLayout(m_pipelineLayout);
+    vkDevice.destroyDescriptorSetLayout(m_descriptorSetLayout);
+    m_descriptorPool = VK_NULL_HANDLE;
+    m_pipeline = VK_NULL_HANDLE;
+    m_pipelineLayout = VK_NULL_HANDLE;
+    m_descriptorSetLayout = VK_NULL_HANDLE;
+}
+
+void ReadbackConverter::recordConversion(vk::CommandBuffer &commandBuffer, const uint8_t &frameInFlightIndex,
+                                         const vk::Image &source, const vk::Extent2D &sourceExtent,
+                                         const vk::ImageLayout &sourceLayout) const
+{
+    assert(frameInFlightIndex < m_frames.size());
+    const FrameResources &frame = m_frames[frameInFlightIndex];
+
+    std::array<vk::ImageMemoryBarrier2, 2> toBlit{
+        vk::ImageMemoryBarrier2()
+            .setOldLayout(sourceLayout)
+            .setNewLayout(vk::ImageLayout::eTransferSrcOptimal)
+            .setSrcStageMask(vk::PipelineStageFlagBits2::eColorAttachmentOutput | vk::PipelineStageFlagBits2::eBlit)
+            .setSrcAccessMask(vk::AccessFlagBits2::eColorAttachmentWrite)
+            .setDstStageMask(vk::PipelineStageFlagBits2::eBlit)
+            .setDstAccessMask(vk::AccessFlagBits2::eTransferRead)
+            .setSrcQueueFamilyIndex(vk::QueueFamilyIgnored)
+            .setDstQueueFamilyIndex(vk::QueueFamilyIgnored)
+            .setImage(source)
+            .setSubresourceRange(ColorRange()),
+        // the previous conversion of this frame in flight finished before the frame was recorded again
+        vk::ImageMemoryBarrier2()
+            .setOldLayout(vk::ImageLayout::eUndefined)
+            .setNewLayout(vk::ImageLayout::eTransferDstOptimal)
+            .setSrcStageMask(vk::PipelineStageFlagBits2::eTopOfPipe)
+            .setSrcAccessMask(vk::AccessFlagBits2::eNone)
+            .setDstStageMask(vk::PipelineStageFlagBits2::eBlit)
+            .setDstAccessMask(vk::AccessFlagBits2::eTransferWrite)
+            .setSrcQueueFamilyIndex(vk::QueueFamilyIgnored)
+            .setDstQueueFamilyIndex(vk::QueueFamilyIgnored)
+            .setImage(frame.image)
+            .setSubresourceRange(ColorRange())};
+    commandBuffer.pipelineBarrier2(vk::DependencyInfo()
+                                       .setImageMemoryBarrierCount(static_cast<uint32_t>(toBlit.size()))
+                                       .setPImageMemoryBarriers(toBlit.data()));
+
+    const auto layers = vk::ImageSubresourceLayers()
+                            .setAspectMask(vk::ImageAspectFlagBits::eColor)
+                            .setMipLevel(0)
+                            .setBaseArrayLayer(0)
+                            .setLayerCount(1);
+    const auto region =
+        vk::ImageBlit()
+            .setSrcSubresource(layers)
+            .setSrcOffsets({vk::Offset3D(0, 0, 0), vk::Offset3D(static_cast<int32_t>(sourceExtent.width),
+                                                                static_cast<int32_t>(sourceExtent.height), 1)})
+            .setDstSubresource(layers)
+            .setDstOffsets({vk::Offset3D(0, 0, 0), vk::Offset3D(static_cast<int32_t>(m_extent.width),
+                                                                static_cast<int32_t>(m_extent.height), 1)});
+    commandBuffer.blitImage(source, vk::ImageLayout::eTransferSrcOptimal, frame.image,
+                            vk::ImageLayout::eTransferDstOptimal, 1, &region, vk::Filter::eLinear);
+
+    std::array<vk::ImageMemoryBarrier2, 2> toCompute{
+        vk::ImageMemoryBarrier2()
+            .setOldLayout(vk::ImageLayout::eTransferSrcOptimal)
+            .setNewLayout(sourceLayout)
+            .setSrcStageMask(vk::PipelineStageFlagBits2::eBlit)
+            .setSrcAccessMask(vk::AccessFlagBits2::eTransferRead)
+            .setDstStageMask(vk::PipelineStageFlagBits2::eBottomOfPipe)
+            .setDstAccessMask(vk::AccessFlagBits2::eNone)
+            .setSrcQueueFamilyIndex(vk::QueueFamilyIgnored)
+            .setDstQueueFamilyIndex(vk::QueueFamilyIgnored)
+            .setImage(source)
+            .setSubresourceRange(ColorRange()),
+        vk::ImageMemoryBarrier2()
+            .setOldLayout(vk::ImageLayout::eTransferDstOptimal)
+            .setNewLayout(vk::ImageLayout::eGeneral)
+            .setSrcStageMask(vk::PipelineStageFlagBits2::eBlit)
+            .setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite)
+            .setDstStageMask(vk::PipelineStageFlagBits2::eComputeShader)
+            .setDstAccessMask(vk::AccessFlagBits2::eShaderStorageRead)
+            .setSrcQueueFamilyIndex(vk::QueueFamilyIgnored)
+            .setDstQueueFamilyIndex(vk::QueueFamilyIgnored)
+            .setImage(frame.image)
+            .setSubresourceRange(ColorRange())};
+    commandBuffer.pipelineBarrier2(vk::DependencyInfo()
+                                       .setImageMemoryBarrierCount(static_cast<uint32_t>(toCompute.size()))
+                                       .setPImageMemoryBarriers(toCompute.data()));
+
+    const PushConstants pushConstants{.width = m_extent.width,
+                                      .height = m_extent.height,
+                                      .planeLayout = m_format == Readback_Format::i420 ? 1u : 0u,
+                                      .encodeSrgb = m_encodeSrgb ? 1u : 0u};
+    commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, m_pipeline);
+    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, m_pipelineLayout, 0, 1, &frame.descriptorSet, 0,
+                                     nullptr);
+    commandBuffer.pushConstants(m_pipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, sizeof(PushConstants),
+                                &pushConstants);
+
+    const uint32_t blocksX = m_extent.width / BlockWidth, blocksY = m_extent.height / BlockHeight;
+    commandBuffer.dispatch((blocksX + WorkgroupSize - 1) / WorkgroupSize, (blocksY + WorkgroupSize - 1) / WorkgroupSize,
+                           1);
+
+    const auto toHost = vk::BufferMemoryBarrier2()
+                            .setSrcStageMask(vk::PipelineStageFlagBits2::eComputeShader)
+                            .setSrcAccessMask(vk::AccessFlagBits2::eShaderStorageWrite)
+                            .setDstStageMask(vk::PipelineStageFlagBits2::eHost)
+                            .setDstAccessMask(vk::AccessFlagBits2::eHostRead)
+                            .setSrcQueueFamilyIndex(vk::QueueFamilyIgnored)
+                            .setDstQueueFamilyIndex(vk::QueueFamilyIgnored)
+                            .setBuffer(frame.buffer)
+                            .setOffset(0)
+                            .setSize(VK_WHOLE_SIZE);
+    commandBuffer.pipelineBarrier2(
+        vk::DependencyInfo().setBufferMemoryBarrierCount(1).setPBufferMemoryBarriers(&toHost));
+}
+
+ReadbackFrame ReadbackConverter::getFrame(core::device::StarDevice &device, const uint8_t &frameInFlightIndex) const
+{
+    assert(frameInFlightIndex < m_frames.size());
+    const FrameResources &frame = m_frames[frameInFlightIndex];
+
+    if (!m_readbackCoherent)
+    {
+        device.getVulkanDevice().invalidateMappedMemoryRanges(
+            vk::MappedMemoryRange().setMemory(frame.bufferMemory).setOffset(0).setSize(VK_WHOLE_SIZE));
+    }
+
+    return ReadbackFrame{.data = frame.mapped,
+                         .size = static_cast<size_t>(m_readbackSize),
+                         .extent = m_extent,
+                         .format = m_format};
+}
+
+void ReadbackConverter::createPipeline(core::device::StarDevice &device)
+{
+    const vk::Device &vkDevice = device.getVulkanDevice();
+
+    const std::array<vk::DescriptorSetLayoutBinding, 2> bindings{
+        vk::DescriptorSetLayoutBinding()
+            .setBinding(0)
+            .setDescriptorType(vk::DescriptorType::eStorageImage)
+            .setDescriptorCount(1)
+            .setStageFlags(vk::ShaderStageFlagBits::eCompute),
+        vk::DescriptorSetLayoutBinding()
+            .setBinding(1)
+            .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+            .setDescriptorCount(1)
+            .setStageFlags(vk::ShaderStageFlagBits::eCompute)};
+    const auto layoutInfo = vk::DescriptorSetLayoutCreateInfo()
+                                .setBindingCount(static_cast<uint32_t>(bindings.size()))
+                                .setPBindings(bindings.data());
+    m_descriptorSetLayout = vkDevice.createDescriptorSetLayout(layoutInfo);
+
+    const auto pushConstantRange = vk::PushConstantRange()
+                                       .setStageFlags(vk::ShaderStageFlagBits::eCompute)
+                                       .setOffset(0)
+                                       .setSize(sizeof(PushConstants));
+    m_pipelineLayout = vkDevice.createPipelineLayout(vk::PipelineLayoutCreateInfo()
+                                                         .setSetLayoutCount(1)
+                                                         .setPSetLayouts(&m_descriptorSetLayout)
+                                                         .setPushConstantRangeCount(1)
+                                                         .setPPushConstantRanges(&pushConstantRange));
+
+    const vk::ShaderModule shaderModule = vkDevice.createShaderModule(
+        vk::ShaderModuleCreateInfo().setCodeSize(sizeof(ReadbackYuvSpirv)).setPCode(ReadbackYuvSpirv));
+
+    const auto pipelineResult = vkDevice.createComputePipeline(
+        VK_NULL_HANDLE, vk::ComputePipelineCreateInfo()
+                            .setStage(vk::PipelineShaderStageCreateInfo()
+                                          .setStage(vk::ShaderStageFlagBits::eCompute)
+                                          .setModule(shaderModule)
+                                          .setPName("main"))
+                            .setLayout(m_pipelineLayout));
+    vkDevice.destroyShaderModule(shaderModule);
+    if (pipelineResult.result != vk::Result::eSuccess)
+    {
+        throw std::runtime_error("Failed to create readback conversion pipeline");
+    }
+    m_pipeline = pipelineResult.value;
+}
+
+void ReadbackConverter::createFrameResources(core::device::StarDevice &device, FrameResources &frame)
+{
+    const vk::Device &vkDevice = device.getVulkanDevice();
+    const vk::PhysicalDevice &physicalDevice = device.getPhysicalDevice();
+    bool found = false;
+
+    frame.image = vkDevice.createImage(vk::ImageCreateInfo()
+                                           .setImageType(vk::ImageType::e2D)
+                                           .setFormat(IntermediateFormat)
+                                           .setExtent(vk::Extent3D(m_extent, 1))
+                                           .setMipLevels(1)
+                                           .setArrayLayers(1)
+                                           .setSamples(vk::SampleCountFlagBits::e1)
+                                           .setTiling(vk::ImageTiling::eOptimal)
+                                           .setUsage(vk::ImageUsageFlagBits::eTransferDst |
+                                                     vk::ImageUsageFlagBits::eStorage)
+                                           .setSharingMode(vk::SharingMode::eExclusive)
+                                           .setInitialLayout(vk::ImageLayout::eUndefined));
+    const vk::MemoryRequirements imageRequirements = vkDevice.getImageMemoryRequirements(frame.image);
+    const uint32_t imageMemoryType = FindMemoryType(physicalDevice, imageRequirements.memoryTypeBits,
+                                                    vk::MemoryPropertyFlagBits::eDeviceLocal, found);
+    if (!found)
+    {
+        throw std::runtime_error("Failed to find device local memory for the readback conversion image");
+    }
+    frame.imageMemory = vkDevice.allocateMemory(
+        vk::MemoryAllocateInfo().setAllocationSize(imageRequirements.size).setMemoryTypeIndex(imageMemoryType));
+    vkDevice.bindImageMemory(frame.image, frame.imageMemory, 0);
+    frame.imageView = vkDevice.createImageView(vk::ImageViewCreateInfo()
+                                                   .setImage(frame.image)
+                                                   .setViewType(vk::ImageViewType::e2D)
+                                                   .setFormat(IntermediateFormat)
+                                                   .setSubresourceRange(ColorRange()));
+
+    frame.buffer = vkDevice.createBuffer(vk::BufferCreateInfo()
+                                             .setSize(m_readbackSize)
+                                             .setUsage(vk::BufferUsageFlagBits::eStorageBuffer)
+                                             .setSharingMode(vk::SharingMode::eExclusive));
+    const vk::MemoryRequirements bufferRequirements = vkDevice.getBufferMemoryRequirements(frame.buffer);
+
+    // cached memory makes reading on the host far faster, fall back to coherent memory which every device has
+    uint32_t memoryType =
+        FindMemoryType(physicalDevice, bufferRequirements.memoryTypeBits,
+                       vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCached, found);
+    if (found)
+    {
+        m_readbackCoherent = (physicalDevice.getMemoryProperties().memoryTypes[memoryType].propertyFlags &
+                              vk::MemoryPropertyFlagBits::eHostCoherent) == vk::MemoryPropertyFlagBits::eHostCoherent;
+    }
+    else
+    {
+        memoryType = FindMemoryType(physicalDevice, bufferRequirements.memoryTypeBits,
+                                    vk::MemoryPropertyFlagBits::eHostVisible |
+                                        vk::MemoryPropertyFlagBits::eHostCoherent,
+                                    found);
+        m_readbackCoherent = true;
+    }
+    if (!found)
+    {
+        throw std::runtime_error("Failed to find host visible memory for the readback buffer");
+    }
+
+    frame.bufferMemory = vkDevice.allocateMemory(
+        vk::MemoryAllocateInfo().setAllocationSize(bufferRequirements.size).setMemoryTypeIndex(memoryType));
+    vkDevice.bindBufferMemory(frame.buffer, frame.bufferMemory, 0);
+    frame.mapped = vkDevice.mapMemory(frame.bufferMemory, 0, VK_WHOLE_SIZE);
+
+    if (!m_descriptorPool)
+    {
+        const std::array<vk::DescriptorPoolSize, 2> poolSizes{
+            vk::DescriptorPoolSize(vk::DescriptorType::eStorageImage, static_cast<uint32_t>(m_frames.size())),
+            vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, static_cast<uint32_t>(m_frames.size()))};
+        m_descriptorPool = vkDevice.createDescriptorPool(vk::DescriptorPoolCreateInfo()
+                                                             .setMaxSets(static_cast<uint32_t>(m_frames.size()))
+                                                             .setPoolSizeCount(static_cast<uint32_t>(poolSizes.size()))
+                                                             .setPPoolSizes(poolSizes.data()));
+    }
+
+    frame.descriptorSet = vkDevice
+                              .allocateDescriptorSets(vk::DescriptorSetAllocateInfo()
+                                                          .setDescriptorPool(m_descriptorPool)
+                                                          .setDescriptorSetCount(1)
+                                                          .setPSetLayouts(&m_descriptorSetLayout))
+                              .front();
+
+    const auto imageInfo =
+        vk::DescriptorImageInfo().setImageView(frame.imageView).setImageLayout(vk::ImageLayout::eGeneral);
+    const auto bufferInfo = vk::DescriptorBufferInfo().setBuffer(frame.buffer).setOffset(0).setRange(VK_WHOLE_SIZE);
+    const std::array<vk::WriteDescriptorSet, 2> writes{vk::WriteDescriptorSet()
+                                                           .setDstSet(frame.descriptorSet)
+                                                           .setDstBinding(0)
+                                                           .setDescriptorCount(1)
+                                                           .setDescriptorType(vk::DescriptorType::eStorageImage)
+                                                           .setPImageInfo(&imageInfo),
+                                                       vk::WriteDescriptorSet()
+                                                           .setDstSet(frame.descriptorSet)
+                                                           .setDstBinding(1)
+                                                           .setDescriptorCount(1)
+                                                           .setDescriptorType(vk::DescriptorType::eStorageBuffer)
+                                                           .setPBufferInfo(&bufferInfo)};
+    vkDevice.updateDescriptorSets(static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+}
+
+uint32_t ReadbackConverter::FindMemoryType(const vk::PhysicalDevice &physicalDevice, const uint32_t &typeBits,
+                                           const vk::MemoryPropertyFlags &properties, bool &found)
+{
+    const vk::PhysicalDeviceMemoryProperties memProperties = physicalDevice.getMemoryProperties();
+
+    for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++)
+    {
+        if ((typeBits & (1u << i)) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties)
+        {
+            found = true;
+            return i;
+        }
+    }
+
+    found = false;
+    return 0;
+}
+
+bool ReadbackConverter::IsSrgbFormat(const vk::Format &format)
+{
+    switch (format)
+    {
+    case vk::Format::eB8G8R8A8Srgb:
+    case vk::Format::eR8G8B8A8Srgb:
+    case vk::Format::eA8B8G8R8SrgbPack32:
+        return true;
+    default:
+        return false;
+    }
+}
+} // namespace star::windowing
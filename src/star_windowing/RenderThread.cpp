@@ -0,0 +1,143 @@
+#include "star_windowing/RenderThread.hpp"
+
+#include "star_windowing/InteractivityBus.hpp"
+
+#include <GLFW/glfw3.h>
+
+#include <cassert>
+#include <chrono>
+
+namespace star::windowing
+{
+std::mutex RenderThread::m_mutex;
+std::condition_variable RenderThread::m_condition;
+std::deque<RenderThread::PendingTask *> RenderThread::m_tasks;
+std::atomic<std::thread::id> RenderThread::m_renderThreadId{};
+std::atomic<bool> RenderThread::m_isRenderLoopDone = false;
+std::atomic<bool> RenderThread::m_isWaitingOnEvents = false;
+
+void RenderThread::Run(WindowingContext &winContext, std::function<void()> engineLoop)
+{
+    assert(winContext.threadingMode == Threading_Mode::dedicated_render_thread &&
+           "Input is only queued for the render thread with Threading_Mode::dedicated_render_thread");
+    assert(!IsRenderThread());
+
+    // joysticks do not generate events, so wake up regularly to sample them
+    constexpr auto gamepadPollInterval = std::chrono::duration<double>(1.0 / 250.0);
+
+    m_isRenderLoopDone.store(false, std::memory_order_release);
+
+    std::exception_ptr renderError;
+    std::thread renderThread([&engineLoop, &renderError]() {
+        m_renderThreadId.store(std::this_thread::get_id(), std::memory_order_release);
+
+        try
+        {
+            engineLoop();
+        }
+        catch (...)
+        {
+            renderError = std::current_exception();
+        }
+
+        m_renderThreadId.store(std::thread::id(), std::memory_order_release);
+        m_isRenderLoopDone.store(true, std::memory_order_release);
+        WakeMainThread();
+    });
+
+    // the window is created and destroyed by the render thread through RunOnMainThread, so keep serving tasks until
+    // the engine loop has returned rather than only while the window is open
+    while (!m_isRenderLoopDone.load(std::memory_order_acquire))
+    {
+        RunPendingTasks(winContext);
+
+        if (m_isWaitingOnEvents.load(std::memory_order_acquire))
+        {
+            glfwWaitEventsTimeout(gamepadPollInterval.count());
+            InteractivityBus::PollGamepadsForRenderThread();
+        }
+        else
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait_for(lock, gamepadPollInterval, []() {
+                return !m_tasks.empty() || m_isRenderLoopDone.load(std::memory_order_acquire);
+            });
+        }
+    }
+
+    renderThread.join();
+    RunPendingTasks(winContext);
+
+    if (renderError)
+    {
+        std::rethrow_exception(renderError);
+    }
+}
+
+void RenderThread::RunOnMainThread(const std::function<void()> &task)
+{
+    if (!IsRenderThread())
+    {
+        task();
+        return;
+    }
+
+    PendingTask pending{&task};
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push_back(&pending);
+    }
+    WakeMainThread();
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [&pending]() { return pending.isDone; });
+    }
+
+    if (pending.error)
+    {
+        std::rethrow_exception(pending.error);
+    }
+}
+
+void RenderThread::RunPendingTasks(WindowingContext &winContext)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_tasks.empty())
+    {
+        PendingTask *pending = m_tasks.front();
+        m_tasks.pop_front();
+        lock.unlock();
+
+        try
+        {
+            (*pending->task)();
+        }
+        catch (...)
+        {
+            pending->error = std::current_exception();
+        }
+
+        // a task may have created or destroyed the window, and GLFW with it. Only wait in GLFW while it exists.
+        m_isWaitingOnEvents.store(winContext.window.getGLFWWindow() != nullptr, std::memory_order_release);
+
+        lock.lock();
+        pending->isDone = true;
+        m_condition.notify_all();
+    }
+}
+
+void RenderThread::WakeMainThread()
+{
+    {
+        // taken so the notification cannot slip in between the main thread checking for tasks and starting to wait
+        std::lock_guard<std::mutex> lock(m_mutex);
+    }
+    m_condition.notify_all();
+
+    if (m_isWaitingOnEvents.load(std::memory_order_acquire))
+    {
+        glfwPostEmptyEvent();
+    }
+}
+} // namespace star::windowing
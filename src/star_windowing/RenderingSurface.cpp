@@ -19,6 +19,24 @@ vk::SurfaceKHR RenderingSurface::CreateSurface(vk::Instance instance, StarWindow
 void RenderingSurface::cleanupRender(vk::Instance instance)
 {
     instance.destroySurfaceKHR(m_surface);
+    m_capabilities.reset();
+}
+
+const vk::SurfaceCapabilities2KHR &RenderingSurface::getCapabilities(const vk::PhysicalDevice &physicalDevice)
+{
+    if (!m_capabilities.has_value())
+    {
+        return refreshCapabilities(physicalDevice);
+    }
+
+    return m_capabilities.value();
+}
+
+const vk::SurfaceCapabilities2KHR &RenderingSurface::refreshCapabilities(const vk::PhysicalDevice &physicalDevice)
+{
+    m_capabilities = physicalDevice.getSurfaceCapabilities2KHR(m_surface);
+
+    return m_capabilities.value();
 }
 
 void RenderingSurface::init(vk::Instance instance, StarWindow &window)
@@ -0,0 +1,64 @@
+#include "star_windowing/SimulationClock.hpp"
+
+#include <stdexcept>
+
+namespace star::windowing
+{
+SimulationClock::SimulationClock(const double &stepSeconds, const uint32_t &maxStepsPerFrame)
+    : m_stepSeconds(stepSeconds), m_maxStepsPerFrame(maxStepsPerFrame)
+{
+    setStepSeconds(stepSeconds);
+    setMaxStepsPerFrame(maxStepsPerFrame);
+}
+
+void SimulationClock::setStepSeconds(const double &stepSeconds)
+{
+    // also rejects NaN, a zero or negative step would never drain the accumulator
+    if (!(stepSeconds > 0.0))
+    {
+        throw std::invalid_argument("Simulation step must be longer than zero seconds");
+    }
+
+    m_stepSeconds = stepSeconds;
+}
+
+void SimulationClock::setMaxStepsPerFrame(const uint32_t &maxStepsPerFrame)
+{
+    if (maxStepsPerFrame == 0)
+    {
+        throw std::invalid_argument("Simulation clock must allow at least one step per frame");
+    }
+
+    m_maxStepsPerFrame = maxStepsPerFrame;
+}
+
+uint32_t SimulationClock::advance()
+{
+    const auto now = Clock::now();
+    const double elapsed = std::chrono::duration<double>(now - m_lastAdvance).count();
+    m_lastAdvance = now;
+
+    m_accumulatedSeconds += elapsed;
+
+    uint32_t steps = 0;
+    while (m_accumulatedSeconds >= m_stepSeconds && steps < m_maxStepsPerFrame)
+    {
+        m_accumulatedSeconds -= m_stepSeconds;
+        steps++;
+    }
+
+    // after a stall, drop the time which could not be caught up rather than trying to simulate all of it later
+    if (m_accumulatedSeconds >= m_stepSeconds)
+    {
+        m_accumulatedSeconds = 0.0;
+    }
+
+    return steps;
+}
+
+void SimulationClock::reset()
+{
+    m_accumulatedSeconds = 0.0;
+    m_lastAdvance = Clock::now();
+}
+} // namespace star::windowing
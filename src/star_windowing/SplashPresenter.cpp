@@ -0,0 +1,472 @@
+#include "star_windowing/SplashPresenter.hpp"
+
+#include "star_windowing/RenderThread.hpp"
+
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+namespace star::windowing
+{
+// nothing changes between splash frames, so only redraw at a modest rate
+constexpr auto SplashFrameInterval = std::chrono::duration<double>(1.0 / 30.0);
+
+SplashPresenter::SplashPresenter(SplashPresenter &&other) noexcept
+    : m_winContext(other.m_winContext), m_device(std::exchange(other.m_device, VK_NULL_HANDLE)),
+      m_physicalDevice(other.m_physicalDevice), m_presentQueue(other.m_presentQueue),
+      m_queueFamilyIndices(std::move(other.m_queueFamilyIndices)),
+      m_swapChain(std::exchange(other.m_swapChain, VK_NULL_HANDLE)), m_format(other.m_format),
+      m_extent(other.m_extent), m_images(std::exchange(other.m_images, {})),
+      m_imageViews(std::exchange(other.m_imageViews, {})),
+      m_commandPool(std::exchange(other.m_commandPool, VK_NULL_HANDLE)),
+      m_commandBuffer(std::exchange(other.m_commandBuffer, VK_NULL_HANDLE)),
+      m_fence(std::exchange(other.m_fence, VK_NULL_HANDLE)), m_clearColor(other.m_clearColor),
+      m_recordCallback(std::move(other.m_recordCallback))
+{
+    // the present thread works on the presenter it was started from
+    assert(!other.m_presentThread.joinable() && "A presenting splash presenter cannot be moved");
+}
+
+SplashPresenter &SplashPresenter::operator=(SplashPresenter &&other)
+{
+    if (this != &other)
+    {
+        assert(!other.m_presentThread.joinable() && "A presenting splash presenter cannot be moved");
+
+        cleanupRender();
+
+        m_winContext = other.m_winContext;
+        m_device = std::exchange(other.m_device, VK_NULL_HANDLE);
+        m_physicalDevice = other.m_physicalDevice;
+        m_presentQueue = other.m_presentQueue;
+        m_queueFamilyIndices = std::move(other.m_queueFamilyIndices);
+        m_swapChain = std::exchange(other.m_swapChain, VK_NULL_HANDLE);
+        m_format = other.m_format;
+        m_extent = other.m_extent;
+        m_images = std::exchange(other.m_images, {});
+        m_imageViews = std::exchange(other.m_imageViews, {});
+        m_commandPool = std::exchange(other.m_commandPool, VK_NULL_HANDLE);
+        m_commandBuffer = std::exchange(other.m_commandBuffer, VK_NULL_HANDLE);
+        m_fence = std::exchange(other.m_fence, VK_NULL_HANDLE);
+        m_clearColor = other.m_clearColor;
+        m_recordCallback = std::move(other.m_recordCallback);
+    }
+
+    return *this;
+}
+
+SplashPresenter::~SplashPresenter()
+{
+    try
+    {
+        cleanupRender();
+    }
+    catch (...)
+    {
+        // such as a lost device while unwinding from a failed initialization, the handles are gone with it
+    }
+}
+
+void SplashPresenter::prepRender(core::device::StarDevice &device)
+{
+    assert(m_winContext != nullptr && "Splash presenter requires a windowing context");
+
+    m_device = device.getVulkanDevice();
+    m_physicalDevice = device.getPhysicalDevice();
+    m_presentQueue = device.getDefaultQueue(star::Queue_Type::Tpresent).getVulkanQueue();
+    m_queueFamilyIndices = device.getQueueOwnershipTracker().getAllQueueFamilyIndices();
+
+    // the present queue lives in the first graphics family able to present to the surface
+    const vk::SurfaceKHR &surface = m_winContext->surface.getVulkanSurface();
+    std::optional<uint32_t> queueFamily;
+    const auto families = m_physicalDevice.getQueueFamilyProperties();
+    for (uint32_t i = 0; i < families.size() && !queueFamily.has_value(); i++)
+    {
+        if ((families[i].queueFlags & vk::QueueFlagBits::eGraphics) &&
+            m_physicalDevice.getSurfaceSupportKHR(i, surface))
+        {
+            queueFamily = i;
+        }
+    }
+    if (!queueFamily.has_value())
+    {
+        throw std::runtime_error("Failed to find a queue family for splash frames");
+    }
+
+    // assigned as they are created, so a failure part way is still cleaned up on destruction
+    m_fence = m_device.createFence(vk::FenceCreateInfo());
+    m_commandPool = m_device.createCommandPool(vk::CommandPoolCreateInfo()
+                                                   .setFlags(vk::CommandPoolCreateFlagBits::eResetCommandBuffer)
+                                                   .setQueueFamilyIndex(queueFamily.value()));
+    m_commandBuffer = m_device
+                          .allocateCommandBuffers(vk::CommandBufferAllocateInfo()
+                                                      .setCommandPool(m_commandPool)
+                                                      .setLevel(vk::CommandBufferLevel::ePrimary)
+                                                      .setCommandBufferCount(1))
+                          .front();
+
+    // only one swapchain can be live on a surface, one left behind by an earlier presenter is retired by this one.
+    // Whoever left it waited for the device to go idle, nothing still uses its images
+    const vk::SwapchainKHR previousSplash = std::exchange(m_winContext->splashSwapChain, VK_NULL_HANDLE);
+    createSwapChain(previousSplash);
+    if (previousSplash)
+    {
+        m_device.destroySwapchainKHR(previousSplash);
+    }
+}
+
+void SplashPresenter::cleanupRender()
+{
+    stopPresenting();
+
+    if (m_device)
+    {
+        m_device.waitIdle();
+    }
+
+    release();
+}
+
+void SplashPresenter::release()
+{
+    destroyImageViews();
+
+    if (m_swapChain)
+    {
+        m_device.destroySwapchainKHR(m_swapChain);
+        m_swapChain = VK_NULL_HANDLE;
+    }
+
+    if (m_commandPool)
+    {
+        // the command buffer is freed along with its pool
+        m_device.destroyCommandPool(m_commandPool);
+        m_commandPool = VK_NULL_HANDLE;
+        m_commandBuffer = VK_NULL_HANDLE;
+    }
+
+    if (m_fence)
+    {
+        m_device.destroyFence(m_fence);
+        m_fence = VK_NULL_HANDLE;
+    }
+
+    m_device = VK_NULL_HANDLE;
+}
+
+void SplashPresenter::releaseToContext()
+{
+    stopPresenting();
+
+    if (m_device)
+    {
+        m_device.waitIdle();
+    }
+
+    if (m_winContext->splashSwapChain)
+    {
+        m_device.destroySwapchainKHR(m_winContext->splashSwapChain);
+    }
+    m_winContext->splashSwapChain = std::exchange(m_swapChain, VK_NULL_HANDLE);
+    release();
+
+    if (m_presentError)
+    {
+        std::rethrow_exception(std::exchange(m_presentError, nullptr));
+    }
+}
+
+void SplashPresenter::present()
+{
+    assert(m_swapChain && "Splash presenter must be prepared before presenting");
+
+    // acquire with a fence rather than a semaphore, the frame is recorded and submitted synchronously anyways
+    vk::ResultValue<uint32_t> acquire{vk::Result::eErrorOutOfDateKHR, 0};
+    try
+    {
+        acquire = m_device.acquireNextImageKHR(m_swapChain, UINT64_MAX, VK_NULL_HANDLE, m_fence);
+    }
+    catch (const vk::OutOfDateKHRError &)
+    {
+        recreateSwapChain();
+        return;
+    }
+    waitForFence("Failed to wait for splash image acquire");
+
+    m_commandBuffer.reset();
+    m_commandBuffer.begin(vk::CommandBufferBeginInfo().setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+    recordFrame(m_commandBuffer, acquire.value);
+    m_commandBuffer.end();
+
+    const auto submitInfo = vk::SubmitInfo().setCommandBufferCount(1).setPCommandBuffers(&m_commandBuffer);
+    if (m_presentQueue.submit(1, &submitInfo, m_fence) != vk::Result::eSuccess)
+    {
+        throw std::runtime_error("Failed to submit splash frame");
+    }
+    waitForFence("Failed to wait for splash frame");
+
+    const auto presentInfo =
+        vk::PresentInfoKHR().setSwapchainCount(1).setPSwapchains(&m_swapChain).setPImageIndices(&acquire.value);
+    try
+    {
+        if (m_presentQueue.presentKHR(presentInfo) == vk::Result::eSuboptimalKHR)
+        {
+            recreateSwapChain();
+        }
+    }
+    catch (const vk::OutOfDateKHRError &)
+    {
+        recreateSwapChain();
+    }
+}
+
+void SplashPresenter::startPresenting()
+{
+    assert(m_swapChain && "Splash presenter must be prepared before presenting");
+    assert(!m_presentThread.joinable() && "Splash presenter is already presenting");
+
+    m_isPresenting = true;
+    m_winContext->splashPresenter = this;
+
+    m_presentThread = std::thread([this]() {
+        std::unique_lock<std::mutex> lock(m_presentMutex);
+        while (m_isPresenting)
+        {
+            lock.unlock();
+            try
+            {
+                presentIfVisible();
+            }
+            catch (...)
+            {
+                // handed to whoever stops presenting, the previous splash frame stays on screen
+                lock.lock();
+                m_presentError = std::current_exception();
+                return;
+            }
+            lock.lock();
+
+            m_presentCondition.wait_for(lock, SplashFrameInterval, [this]() { return !m_isPresenting; });
+        }
+    });
+}
+
+void SplashPresenter::stopPresenting()
+{
+    if (!m_presentThread.joinable())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_presentMutex);
+        m_isPresenting = false;
+    }
+    m_presentCondition.notify_all();
+    m_presentThread.join();
+
+    if (m_winContext->splashPresenter == this)
+    {
+        m_winContext->splashPresenter = nullptr;
+    }
+}
+
+void SplashPresenter::presentUntil(const std::function<bool()> &isReady)
+{
+    // with a render thread the main thread is already pumping events, only wait here
+    const bool pumpEvents = !RenderThread::IsRenderThread();
+
+    while (!isReady() && !m_winContext->window.shouldClose())
+    {
+        if (!m_presentThread.joinable())
+        {
+            presentIfVisible();
+        }
+
+        if (pumpEvents)
+        {
+            glfwWaitEventsTimeout(SplashFrameInterval.count());
+        }
+        else
+        {
+            std::this_thread::sleep_for(SplashFrameInterval);
+        }
+    }
+}
+
+void SplashPresenter::presentIfVisible()
+{
+    const vk::Extent2D framebufferSize = m_winContext->window.getWindowFramebufferSize();
+    if (framebufferSize.width != 0 && framebufferSize.height != 0)
+    {
+        present();
+    }
+}
+
+void SplashPresenter::waitForFence(const char *errorMessage)
+{
+    if (m_device.waitForFences(1, &m_fence, VK_TRUE, UINT64_MAX) != vk::Result::eSuccess)
+    {
+        throw std::runtime_error(errorMessage);
+    }
+    if (m_device.resetFences(1, &m_fence) != vk::Result::eSuccess)
+    {
+        throw std::runtime_error("Failed to reset splash fence");
+    }
+}
+
+void SplashPresenter::createSwapChain(const vk::SwapchainKHR &oldSwapChain)
+{
+    // queried directly rather than through the surface's cache, this may run on the present thread
+    const vk::SurfaceKHR &surface = m_winContext->surface.getVulkanSurface();
+    const vk::SurfaceCapabilitiesKHR caps = m_physicalDevice.getSurfaceCapabilitiesKHR(surface);
+    const auto formats = m_physicalDevice.getSurfaceFormatsKHR(surface);
+    if (formats.empty())
+    {
+        throw std::runtime_error("Failed to get any available formats for splash swapchain images");
+    }
+
+    vk::SurfaceFormatKHR format = formats.front();
+    for (const auto &available : formats)
+    {
+        if (available.format == vk::Format::eB8G8R8A8Srgb && available.colorSpace == vk::ColorSpaceKHR::eSrgbNonlinear)
+        {
+            format = available;
+            break;
+        }
+    }
+
+    m_format = format.format;
+    m_extent = m_winContext->window.getWindowFramebufferSize();
+    m_extent.width = std::clamp(m_extent.width, caps.minImageExtent.width, caps.maxImageExtent.width);
+    m_extent.height = std::clamp(m_extent.height, caps.minImageExtent.height, caps.maxImageExtent.height);
+
+    uint32_t numImages = caps.minImageCount + 1;
+    if (caps.maxImageCount != 0)
+    {
+        numImages = std::min(numImages, caps.maxImageCount);
+    }
+
+    const bool isConcurrent = m_queueFamilyIndices.size() > 1;
+
+    // FIFO is always available and the splash has no reason to run faster than the display
+    m_swapChain = m_device.createSwapchainKHR(
+        vk::SwapchainCreateInfoKHR()
+            .setSurface(surface)
+            .setMinImageCount(numImages)
+            .setImageFormat(format.format)
+            .setImageColorSpace(format.colorSpace)
+            .setImageExtent(m_extent)
+            .setImageArrayLayers(1)
+            .setImageUsage(vk::ImageUsageFlagBits::eColorAttachment)
+            .setImageSharingMode(isConcurrent ? vk::SharingMode::eConcurrent : vk::SharingMode::eExclusive)
+            .setQueueFamilyIndexCount(isConcurrent ? (uint32_t)m_queueFamilyIndices.size() : 0)
+            .setPQueueFamilyIndices(isConcurrent ? m_queueFamilyIndices.data() : nullptr)
+            .setPreTransform(caps.currentTransform)
+            .setCompositeAlpha(vk::CompositeAlphaFlagBitsKHR::eOpaque)
+            .setPresentMode(vk::PresentModeKHR::eFifo)
+            .setClipped(VK_TRUE)
+            .setOldSwapchain(oldSwapChain));
+
+    m_images = m_device.getSwapchainImagesKHR(m_swapChain);
+    for (const auto &image : m_images)
+    {
+        m_imageViews.push_back(m_device.createImageView(
+            vk::ImageViewCreateInfo()
+                .setImage(image)
+                .setViewType(vk::ImageViewType::e2D)
+                .setFormat(m_format)
+                .setSubresourceRange(vk::ImageSubresourceRange()
+                                         .setAspectMask(vk::ImageAspectFlagBits::eColor)
+                                         .setBaseMipLevel(0)
+                                         .setLevelCount(1)
+                                         .setBaseArrayLayer(0)
+                                         .setLayerCount(1))));
+    }
+}
+
+void SplashPresenter::recreateSwapChain()
+{
+    // only the present queue is waited on, other queues may be busy with initialization on another thread. Every
+    // splash submission was already waited for, this lets presentation of the old images finish
+    m_presentQueue.waitIdle();
+    destroyImageViews();
+
+    const vk::SwapchainKHR oldSwapChain = std::exchange(m_swapChain, VK_NULL_HANDLE);
+    createSwapChain(oldSwapChain);
+    m_device.destroySwapchainKHR(oldSwapChain);
+}
+
+void SplashPresenter::destroyImageViews()
+{
+    for (auto &imageView : m_imageViews)
+    {
+        m_device.destroyImageView(imageView);
+    }
+    m_imageViews.clear();
+    m_images.clear();
+}
+
+void SplashPresenter::recordFrame(vk::CommandBuffer &commandBuffer, const uint32_t &imageIndex)
+{
+    const auto subresourceRange = vk::ImageSubresourceRange()
+                                      .setAspectMask(vk::ImageAspectFlagBits::eColor)
+                                      .setBaseMipLevel(0)
+                                      .setLevelCount(1)
+                                      .setBaseArrayLayer(0)
+                                      .setLayerCount(1);
+
+    // previous contents are never needed, the image is cleared every frame
+    const auto toAttachment = vk::ImageMemoryBarrier2()
+                                  .setOldLayout(vk::ImageLayout::eUndefined)
+                                  .setNewLayout(vk::ImageLayout::eColorAttachmentOptimal)
+                                  .setSrcStageMask(vk::PipelineStageFlagBits2::eTopOfPipe)
+                                  .setSrcAccessMask(vk::AccessFlagBits2::eNone)
+                                  .setDstStageMask(vk::PipelineStageFlagBits2::eColorAttachmentOutput)
+                                  .setDstAccessMask(vk::AccessFlagBits2::eColorAttachmentWrite)
+                                  .setSrcQueueFamilyIndex(vk::QueueFamilyIgnored)
+                                  .setDstQueueFamilyIndex(vk::QueueFamilyIgnored)
+                                  .setImage(m_images[imageIndex])
+                                  .setSubresourceRange(subresourceRange);
+    commandBuffer.pipelineBarrier2(
+        vk::DependencyInfo().setImageMemoryBarrierCount(1).setPImageMemoryBarriers(&toAttachment));
+
+    const auto colorAttachment = vk::RenderingAttachmentInfo()
+                                     .setImageView(m_imageViews[imageIndex])
+                                     .setImageLayout(vk::ImageLayout::eColorAttachmentOptimal)
+                                     .setLoadOp(vk::AttachmentLoadOp::eClear)
+                                     .setStoreOp(vk::AttachmentStoreOp::eStore)
+                                     .setClearValue(vk::ClearValue{vk::ClearColorValue{m_clearColor}});
+    commandBuffer.beginRendering(vk::RenderingInfo()
+                                     .setRenderArea(vk::Rect2D({0, 0}, m_extent))
+                                     .setLayerCount(1)
+                                     .setColorAttachmentCount(1)
+                                     .setPColorAttachments(&colorAttachment));
+
+    if (m_recordCallback)
+    {
+        m_recordCallback(commandBuffer, m_imageViews[imageIndex], m_extent);
+    }
+
+    commandBuffer.endRendering();
+
+    const auto toPresent = vk::ImageMemoryBarrier2()
+                               .setOldLayout(vk::ImageLayout::eColorAttachmentOptimal)
+                               .setNewLayout(vk::ImageLayout::ePresentSrcKHR)
+                               .setSrcStageMask(vk::PipelineStageFlagBits2::eColorAttachmentOutput)
+                               .setSrcAccessMask(vk::AccessFlagBits2::eColorAttachmentWrite)
+                               .setDstStageMask(vk::PipelineStageFlagBits2::eBottomOfPipe)
+                               .setDstAccessMask(vk::AccessFlagBits2::eNone)
+                               .setSrcQueueFamilyIndex(vk::QueueFamilyIgnored)
+                               .setDstQueueFamilyIndex(vk::QueueFamilyIgnored)
+                               .setImage(m_images[imageIndex])
+                               .setSubresourceRange(subresourceRange);
+    commandBuffer.pipelineBarrier2(
+        vk::DependencyInfo().setImageMemoryBarrierCount(1).setPImageMemoryBarriers(&toPresent));
+}
+} // namespace star::windowing
@@ -1,25 +1,157 @@
 #include "star_windowing/StarWindow.hpp"
 
+#include "star_windowing/RenderThread.hpp"
+
+#include <cassert>
+#include <cstdlib>
+#include <stdexcept>
+
+#ifdef STAR_WINDOWING_X11_BYPASS_COMPOSITOR
+#define GLFW_EXPOSE_NATIVE_X11
+#include <GLFW/glfw3native.h>
+#include <X11/Xatom.h>
+#endif
+
 namespace star::windowing
 {
+bool StarWindow::m_isGLFWInitialized = false;
+
+StarWindow::StarWindow(StarWindow &&other) noexcept
+    : m_windowSize(other.m_windowSize.load()), m_framebufferSize(other.m_framebufferSize.load()),
+      m_contentScale(other.m_contentScale.load()), m_position(other.m_position.load()),
+      m_focused(other.m_focused.load()), frambufferResized(other.frambufferResized.load()),
+      m_closeRequested(other.m_closeRequested.load()), m_cursorCaptured(other.m_cursorCaptured.load()),
+      m_lastResizeTicks(other.m_lastResizeTicks.load()), m_refreshCallback(std::move(other.m_refreshCallback)),
+      m_displayMode(other.m_displayMode), m_refreshRate(other.m_refreshRate), window(other.window)
+{
+    other.window = nullptr;
+
+    if (this->window != nullptr)
+    {
+        glfwSetWindowUserPointer(this->window, this);
+    }
+}
+
+StarWindow &StarWindow::operator=(StarWindow &&other) noexcept
+{
+    if (this != &other)
+    {
+        m_windowSize.store(other.m_windowSize.load());
+        m_framebufferSize.store(other.m_framebufferSize.load());
+        m_contentScale.store(other.m_contentScale.load());
+        m_position.store(other.m_position.load());
+        m_focused.store(other.m_focused.load());
+        frambufferResized.store(other.frambufferResized.load());
+        m_closeRequested.store(other.m_closeRequested.load());
+        m_cursorCaptured.store(other.m_cursorCaptured.load());
+        m_lastResizeTicks.store(other.m_lastResizeTicks.load());
+        m_refreshCallback = std::move(other.m_refreshCallback);
+        m_displayMode = other.m_displayMode;
+        m_refreshRate = other.m_refreshRate;
+
+        // only the window is destroyed, DestroyWindow would also terminate GLFW while other's window still needs it
+        if (window != nullptr)
+        {
+            glfwDestroyWindow(window);
+        }
+        window = other.window;
+        other.window = nullptr;
+
+        if (this->window != nullptr)
+        {
+            glfwSetWindowUserPointer(this->window, this);
+        }
+    }
+
+    return *this;
+}
 
 void StarWindow::cleanupRender(){
-    DestroyWindow(this->window);
+    if (this->window != nullptr)
+    {
+        DestroyWindow(this->window);
+        this->window = nullptr;
+    }
+}
+
+void StarWindow::InitGLFW()
+{
+    if (!m_isGLFWInitialized)
+    {
+        if (glfwInit() != GLFW_TRUE)
+        {
+            throw std::runtime_error("Failed to initialize GLFW");
+        }
+        m_isGLFWInitialized = true;
+    }
+}
+
+void StarWindow::requestClose()
+{
+    m_closeRequested.store(true, std::memory_order_release);
+    glfwPostEmptyEvent();
+}
+
+void StarWindow::setCursorCaptured(const bool &captured)
+{
+    assert(this->window != nullptr);
+
+    RenderThread::RunOnMainThread([this, &captured]() {
+        glfwSetInputMode(this->window, GLFW_CURSOR, captured ? GLFW_CURSOR_DISABLED : GLFW_CURSOR_NORMAL);
+
+        if (glfwRawMouseMotionSupported())
+        {
+            glfwSetInputMode(this->window, GLFW_RAW_MOUSE_MOTION, captured ? GLFW_TRUE : GLFW_FALSE);
+        }
+    });
+
+    m_cursorCaptured.store(captured, std::memory_order_release);
 }
 
 void StarWindow::initWindowInfo()
 {
     // need to give GLFW a pointer to current instance of this class
     glfwSetWindowUserPointer(this->window, this);
-    // glfwSetFramebufferSizeCallback(window, framebufferResizeCallback);
+    glfwSetFramebufferSizeCallback(this->window, StarWindow::GlfwCallbackFramebufferSize);
+    glfwSetWindowCloseCallback(this->window, StarWindow::GlfwCallbackWindowClose);
+    glfwSetWindowRefreshCallback(this->window, StarWindow::GlfwCallbackWindowRefresh);
+    glfwSetWindowSizeCallback(this->window, StarWindow::GlfwCallbackWindowSize);
+    glfwSetWindowContentScaleCallback(this->window, StarWindow::GlfwCallbackContentScale);
+    glfwSetWindowPosCallback(this->window, StarWindow::GlfwCallbackWindowPosition);
+    glfwSetWindowFocusCallback(this->window, StarWindow::GlfwCallbackWindowFocus);
+
+    refreshCachedMetrics();
     // auto callback = glfwSetKeyCallback(this->window, InteractionSystem::glfwKeyHandle);
     // auto mouseButtonCallback = glfwSetMouseButtonCallback(this->window, InteractionSystem::glfwMouseButtonCallback);
     // auto cursorCallback = glfwSetCursorPosCallback(this->window, InteractionSystem::glfwMouseMovement);
     // auto mouseScrollCallback = glfwSetScrollCallback(this->window, InteractionSystem::glfwScrollCallback);
 }
 
-StarWindow::StarWindow(const int &width, const int &height, const std::string &title)
-    : window(CreateGLFWWindow(width, height, title))
+void StarWindow::refreshCachedMetrics()
+{
+    int width = 0, height = 0;
+    glfwGetWindowSize(this->window, &width, &height);
+    m_windowSize.store(PackPair(static_cast<uint32_t>(width), static_cast<uint32_t>(height)),
+                       std::memory_order_release);
+
+    glfwGetFramebufferSize(this->window, &width, &height);
+    m_framebufferSize.store(PackPair(static_cast<uint32_t>(width), static_cast<uint32_t>(height)),
+                            std::memory_order_release);
+
+    float xscale = 1.0f, yscale = 1.0f;
+    glfwGetWindowContentScale(this->window, &xscale, &yscale);
+    m_contentScale.store(PackPair(std::bit_cast<uint32_t>(xscale), std::bit_cast<uint32_t>(yscale)),
+                         std::memory_order_release);
+
+    int xpos = 0, ypos = 0;
+    glfwGetWindowPos(this->window, &xpos, &ypos);
+    m_position.store(PackPair(static_cast<uint32_t>(xpos), static_cast<uint32_t>(ypos)), std::memory_order_release);
+
+    m_focused.store(glfwGetWindowAttrib(this->window, GLFW_FOCUSED) == GLFW_TRUE, std::memory_order_release);
+}
+
+StarWindow::StarWindow(const Builder &settings)
+    : m_displayMode(settings.displayMode), window(CreateGLFWWindow(settings, m_refreshRate))
 {
     initWindowInfo();
 }
@@ -42,32 +174,217 @@ StarWindow::Builder &StarWindow::Builder::setTitle(const std::string &nTitle)
     return *this;
 }
 
+StarWindow::Builder &StarWindow::Builder::setResizable(const bool &nResizable)
+{
+    this->resizable = nResizable;
+    return *this;
+}
+
+StarWindow::Builder &StarWindow::Builder::setDisplayMode(const Display_Mode &nDisplayMode)
+{
+    this->displayMode = nDisplayMode;
+    return *this;
+}
+
+StarWindow::Builder &StarWindow::Builder::setMonitor(const int &nMonitorIndex)
+{
+    this->monitorIndex = nMonitorIndex;
+    return *this;
+}
+
+StarWindow::Builder &StarWindow::Builder::setRefreshRate(const int &nRefreshRate)
+{
+    this->refreshRate = nRefreshRate;
+    return *this;
+}
+
 StarWindow StarWindow::Builder::build(){
-    return StarWindow(this->width, this->height, this->title);
+    return StarWindow(*this);
 }
 
 std::unique_ptr<StarWindow> StarWindow::Builder::buildUnique()
 {
-    assert(this->width > 0 && this->height > 0 && "Width and height must be defined");
+    assert((this->displayMode == Display_Mode::borderless_fullscreen || (this->width > 0 && this->height > 0)) &&
+           "Width and height must be defined");
 
-    return std::unique_ptr<StarWindow>(new StarWindow(this->width, this->height, this->title));
+    return std::unique_ptr<StarWindow>(new StarWindow(*this));
 }
 
-GLFWwindow *StarWindow::CreateGLFWWindow(const int &width, const int &height, const std::string &title)
+GLFWwindow *StarWindow::CreateGLFWWindow(const Builder &settings, int &selectedRefreshRate)
 {
-    glfwInit();
+    InitGLFW();
+    glfwDefaultWindowHints();
     // tell GLFW to create a window but to not include a openGL instance as this is a default behavior
     glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
 
-    // disable resizing functionality in glfw as this will not be handled in the first tutorial
-    glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+    glfwWindowHint(GLFW_RESIZABLE, settings.resizable ? GLFW_TRUE : GLFW_FALSE);
+
+    selectedRefreshRate = 0;
+    if (settings.displayMode == Display_Mode::windowed)
+    {
+        return glfwCreateWindow(settings.width, settings.height, settings.title.c_str(), nullptr, nullptr);
+    }
+
+    GLFWmonitor *monitor = SelectMonitor(settings.monitorIndex);
+    const GLFWvidmode *mode = nullptr;
+    if (settings.displayMode == Display_Mode::borderless_fullscreen)
+    {
+        // matching the current mode exactly makes GLFW cover the monitor without a mode switch
+        mode = glfwGetVideoMode(monitor);
+        glfwWindowHint(GLFW_RED_BITS, mode->redBits);
+        glfwWindowHint(GLFW_GREEN_BITS, mode->greenBits);
+        glfwWindowHint(GLFW_BLUE_BITS, mode->blueBits);
+        // stay up when focus moves to another monitor
+        glfwWindowHint(GLFW_AUTO_ICONIFY, GLFW_FALSE);
+    }
+    else
+    {
+        mode = SelectVideoMode(monitor, settings.width, settings.height, settings.refreshRate);
+    }
+    glfwWindowHint(GLFW_REFRESH_RATE, mode->refreshRate);
+    selectedRefreshRate = mode->refreshRate;
+
+    GLFWwindow *window = glfwCreateWindow(mode->width, mode->height, settings.title.c_str(), monitor, nullptr);
+    if (window != nullptr)
+    {
+        RequestCompositorBypass(window);
+    }
+
+    return window;
+}
+
+GLFWmonitor *StarWindow::SelectMonitor(const int &monitorIndex)
+{
+    int count = 0;
+    GLFWmonitor **monitors = glfwGetMonitors(&count);
+    if (monitors == nullptr || count == 0)
+    {
+        throw std::runtime_error("No monitors available for fullscreen display");
+    }
 
-    return glfwCreateWindow(width, height, title.c_str(), nullptr, nullptr);
+    // the primary monitor is always first
+    return monitorIndex >= 0 && monitorIndex < count ? monitors[monitorIndex] : monitors[0];
+}
+
+const GLFWvidmode *StarWindow::SelectVideoMode(GLFWmonitor *monitor, const int &width, const int &height,
+                                               const int &refreshRate)
+{
+    int count = 0;
+    const GLFWvidmode *modes = glfwGetVideoModes(monitor, &count);
+
+    const GLFWvidmode *selected = nullptr;
+    for (int i = 0; i < count; i++)
+    {
+        const GLFWvidmode &mode = modes[i];
+        if (mode.width != width || mode.height != height)
+        {
+            continue;
+        }
+
+        if (selected == nullptr)
+        {
+            selected = &mode;
+        }
+        else if (refreshRate > 0)
+        {
+            if (std::abs(mode.refreshRate - refreshRate) < std::abs(selected->refreshRate - refreshRate))
+            {
+                selected = &mode;
+            }
+        }
+        else if (mode.refreshRate > selected->refreshRate)
+        {
+            selected = &mode;
+        }
+    }
+
+    return selected != nullptr ? selected : glfwGetVideoMode(monitor);
+}
+
+void StarWindow::RequestCompositorBypass(GLFWwindow *window)
+{
+#ifdef STAR_WINDOWING_X11_BYPASS_COMPOSITOR
+    // null when GLFW is running on another platform, such as wayland
+    Display *display = glfwGetX11Display();
+    if (display == nullptr)
+    {
+        return;
+    }
+
+    // 1 asks the compositor to unredirect the window, see the _NET_WM_BYPASS_COMPOSITOR hint of the EWMH spec
+    const unsigned long bypass = 1;
+    const Atom bypassAtom = XInternAtom(display, "_NET_WM_BYPASS_COMPOSITOR", False);
+    XChangeProperty(display, glfwGetX11Window(window), bypassAtom, XA_CARDINAL, 32, PropModeReplace,
+                    reinterpret_cast<const unsigned char *>(&bypass), 1);
+    XFlush(display);
+#else
+    (void)window;
+#endif
 }
 
 void StarWindow::DestroyWindow(GLFWwindow *window){
     glfwDestroyWindow(window);
     glfwTerminate();
+    m_isGLFWInitialized = false;
+}
+
+void StarWindow::GlfwCallbackFramebufferSize(GLFWwindow *window, int width, int height)
+{
+    auto *starWindow = static_cast<StarWindow *>(glfwGetWindowUserPointer(window));
+    starWindow->m_framebufferSize.store(PackPair(static_cast<uint32_t>(width), static_cast<uint32_t>(height)),
+                                        std::memory_order_release);
+    starWindow->m_lastResizeTicks.store(std::chrono::steady_clock::now().time_since_epoch().count(),
+                                        std::memory_order_release);
+    starWindow->frambufferResized.store(true, std::memory_order_release);
+}
+
+void StarWindow::GlfwCallbackWindowClose(GLFWwindow *window)
+{
+    auto *starWindow = static_cast<StarWindow *>(glfwGetWindowUserPointer(window));
+    starWindow->m_closeRequested.store(true, std::memory_order_release);
+}
+
+void StarWindow::GlfwCallbackWindowSize(GLFWwindow *window, int width, int height)
+{
+    auto *starWindow = static_cast<StarWindow *>(glfwGetWindowUserPointer(window));
+    starWindow->m_windowSize.store(PackPair(static_cast<uint32_t>(width), static_cast<uint32_t>(height)),
+                                   std::memory_order_release);
+}
+
+void StarWindow::GlfwCallbackContentScale(GLFWwindow *window, float xscale, float yscale)
+{
+    auto *starWindow = static_cast<StarWindow *>(glfwGetWindowUserPointer(window));
+    starWindow->m_contentScale.store(PackPair(std::bit_cast<uint32_t>(xscale), std::bit_cast<uint32_t>(yscale)),
+                                     std::memory_order_release);
+}
+
+void StarWindow::GlfwCallbackWindowPosition(GLFWwindow *window, int xpos, int ypos)
+{
+    auto *starWindow = static_cast<StarWindow *>(glfwGetWindowUserPointer(window));
+    starWindow->m_position.store(PackPair(static_cast<uint32_t>(xpos), static_cast<uint32_t>(ypos)),
+                                 std::memory_order_release);
+}
+
+void StarWindow::GlfwCallbackWindowFocus(GLFWwindow *window, int focused)
+{
+    auto *starWindow = static_cast<StarWindow *>(glfwGetWindowUserPointer(window));
+    starWindow->m_focused.store(focused == GLFW_TRUE, std::memory_order_release);
+}
+
+void StarWindow::GlfwCallbackWindowRefresh(GLFWwindow *window)
+{
+    auto *starWindow = static_cast<StarWindow *>(glfwGetWindowUserPointer(window));
+
+    // outside of a resize the regular frame loop keeps the contents up to date
+    if (starWindow == nullptr || !starWindow->m_refreshCallback || starWindow->m_refreshing ||
+        !starWindow->wasWindowResized())
+    {
+        return;
+    }
+
+    starWindow->m_refreshing = true;
+    starWindow->m_refreshCallback();
+    starWindow->m_refreshing = false;
 }
 
 } // namespace star
\ No newline at end of file
@@ -1,12 +1,13 @@
 #include "star_windowing/SwapChainRenderer.hpp"
 
-#include <star_common/HandleTypeRegistry.hpp>
 #include <starlight/common/ConfigFile.hpp>
 #include <starlight/core/device/managers/Semaphore.hpp>
-#include <starlight/core/device/system/event/ManagerRequest.hpp>
 
 #include <GLFW/glfw3.h>
 
+#include <optional>
+#include <utility>
+
 star::windowing::SwapChainRenderer::SwapChainRenderer(WindowingContext *winContext, vk::SwapchainKHR swapChain,
                                                       core::device::DeviceContext &context,
                                                       const uint8_t &numFramesInFlight,
@@ -36,7 +37,17 @@ star::windowing::SwapChainRenderer::SwapChainRenderer(SwapChainRenderer &&other)
     : DefaultRenderer(std::move(other)), m_winContext(other.m_winContext), m_swapChain(std::move(other.m_swapChain)),
       device(other.device), numFramesInFlight(std::move(other.numFramesInFlight)),
       m_presentationSharedDeps(std::move(other.m_presentationSharedDeps)),
-      m_presentationCommands(std::move(other.m_presentationCommands))
+      m_presentationCommands(std::move(other.m_presentationCommands)),
+      m_frameExporter(std::move(other.m_frameExporter)), m_readbackConverter(std::move(other.m_readbackConverter)),
+      m_readbackCallback(std::move(other.m_readbackCallback)),
+      m_damage(std::move(other.m_damage)), m_finalComputePass(std::move(other.m_finalComputePass)),
+      m_copyStageFormat(other.m_copyStageFormat), m_swapChainGeneration(other.m_swapChainGeneration),
+      m_cachedCommandPool(std::exchange(other.m_cachedCommandPool, VK_NULL_HANDLE)),
+      m_cachedCommandBuffers(std::move(other.m_cachedCommandBuffers)),
+      m_cachedCommandBuffersValid(std::move(other.m_cachedCommandBuffersValid)),
+      m_pendingReadbacks(std::move(other.m_pendingReadbacks)), m_readbackSequence(other.m_readbackSequence),
+      m_lastDeliveredReadback(other.m_lastDeliveredReadback), m_pooledSemaphores(std::move(other.m_pooledSemaphores)),
+      m_skippedFrameSemaphore(std::exchange(other.m_skippedFrameSemaphore, {}))
 {
     m_presentationCommands.init(&m_presentationSharedDeps, &m_swapChain);
 }
@@ -52,6 +63,21 @@ star::windowing::SwapChainRenderer &star::windowing::SwapChainRenderer::operator
         m_swapChain = other.m_swapChain;
         m_presentationSharedDeps = std::move(other.m_presentationSharedDeps);
         m_presentationCommands = std::move(other.m_presentationCommands);
+        m_frameExporter = std::move(other.m_frameExporter);
+        m_readbackConverter = std::move(other.m_readbackConverter);
+        m_readbackCallback = std::move(other.m_readbackCallback);
+        m_damage = std::move(other.m_damage);
+        m_finalComputePass = std::move(other.m_finalComputePass);
+        m_copyStageFormat = other.m_copyStageFormat;
+        m_swapChainGeneration = other.m_swapChainGeneration;
+        m_pooledSemaphores = std::move(other.m_pooledSemaphores);
+        m_skippedFrameSemaphore = std::exchange(other.m_skippedFrameSemaphore, {});
+        m_cachedCommandPool = std::exchange(other.m_cachedCommandPool, VK_NULL_HANDLE);
+        m_cachedCommandBuffers = std::move(other.m_cachedCommandBuffers);
+        m_cachedCommandBuffersValid = std::move(other.m_cachedCommandBuffersValid);
+        m_pendingReadbacks = std::move(other.m_pendingReadbacks);
+        m_readbackSequence = other.m_readbackSequence;
+        m_lastDeliveredReadback = other.m_lastDeliveredReadback;
 
         m_presentationCommands.init(&m_presentationSharedDeps, &m_swapChain);
     }
@@ -66,8 +92,15 @@ void star::windowing::SwapChainRenderer::prepRender(common::IDeviceContext &cont
     auto &c = static_cast<core::device::DeviceContext &>(context);
     const size_t numSwapChainImages = c.getDevice().getVulkanDevice().getSwapchainImagesKHR(m_swapChain).size();
 
-    this->imageAvailableSemaphores =
-        CreateSemaphores(c, c.getFrameTracker().getSetup().getNumUniqueTargetFramesForFinalization(), false);
+    // semaphores used to sync rendering and presentation queues
+    m_pooledSemaphores = m_winContext->syncObjects.acquireSemaphores(
+        c.getDevice(), c.getEventBus(), c.getFrameTracker().getSetup().getNumUniqueTargetFramesForFinalization());
+    this->imageAvailableSemaphores.clear();
+    for (const auto &semaphore : m_pooledSemaphores)
+    {
+        this->imageAvailableSemaphores.push_back(semaphore.handle);
+    }
+    m_skippedFrameSemaphore = m_winContext->syncObjects.acquireSemaphores(c.getDevice(), c.getEventBus(), 1).front();
 
     // this->createFences(c);
     // this->createFenceImageTracking();
@@ -75,19 +108,58 @@ void star::windowing::SwapChainRenderer::prepRender(common::IDeviceContext &cont
     m_presentationCommands.init(&m_presentationSharedDeps, &m_swapChain);
 
     m_presentationCommands.prepRender(c);
+
+    prepCopyStages(c);
+
+    if (usesCachedCommandBuffers())
+    {
+        prepCachedCommandBuffers(c);
+    }
+
+    m_damage.reset(static_cast<uint32_t>(m_renderToImages.size()), m_winContext->swapChainInfo.extent);
+    publishPendingDamage();
+
+    m_swapChainGeneration = m_winContext->swapChainInfo.generation;
 }
 
 void star::windowing::SwapChainRenderer::cleanupRender(common::IDeviceContext &context)
 {
     DefaultRenderer::cleanupRender(context);
+
+    cleanupCopyStages(static_cast<core::device::DeviceContext &>(context));
+    // a later renderer starts without a final compute pass, the swapchain goes back to sRGB for it
+    m_winContext->hasFinalComputePass = false;
+
+    cleanupCachedCommandBuffers(static_cast<core::device::DeviceContext &>(context));
+
+    // the renderer is only torn down once its submissions and presents have drained
+    for (const auto &semaphore : m_pooledSemaphores)
+    {
+        m_winContext->syncObjects.releaseSemaphore(semaphore);
+    }
+    m_pooledSemaphores.clear();
+    this->imageAvailableSemaphores.clear();
+    if (m_skippedFrameSemaphore.semaphore != nullptr)
+    {
+        m_winContext->syncObjects.releaseSemaphore(m_skippedFrameSemaphore);
+        m_skippedFrameSemaphore = SyncObjectPool::Semaphore{};
+    }
 }
 
 void star::windowing::SwapChainRenderer::frameUpdate(common::IDeviceContext &context)
 {
+    auto &c = static_cast<core::device::DeviceContext &>(context);
+    if (m_winContext->swapChainInfo.generation != m_swapChainGeneration)
+    {
+        recreateSwapChain(c);
+    }
+
     DefaultRenderer::frameUpdate(context);
 
-    auto &c = static_cast<core::device::DeviceContext &>(context);
     prepareRenderingContext(c);
+
+    m_exportThisFrame =
+        m_winContext->syncInfo.imageAcquired && m_frameExporter && m_frameExporter->beginFrame(c.getDevice());
 }
 
 star::core::device::manager::ManagerCommandBuffer::Request star::windowing::SwapChainRenderer::getCommandBufferRequest()
@@ -100,29 +172,18 @@ star::core::device::manager::ManagerCommandBuffer::Request star::windowing::Swap
         .type = Queue_Type::Tgraphics,
         .waitStage = vk::PipelineStageFlagBits::eFragmentShader,
         .willBeSubmittedEachFrame = true,
-        .recordOnce = false,
+        // with cached command buffers the manager's buffer is never submitted, no need to keep re-recording it
+        .recordOnce = usesCachedCommandBuffers(),
         .overrideBufferSubmissionCallback =
             std::bind(&SwapChainRenderer::submitBuffer, this, std::placeholders::_1, std::placeholders::_2,
                       std::placeholders::_3, std::placeholders::_4, std::placeholders::_5, std::placeholders::_6)};
 }
 
-vk::SurfaceFormatKHR star::windowing::SwapChainRenderer::chooseSwapSurfaceFormat(
-    const std::vector<vk::SurfaceFormatKHR> &availableFormats) const
+bool star::windowing::SwapChainRenderer::usesCachedCommandBuffers() const
 {
-    for (const auto &availableFormat : availableFormats)
-    {
-        // check if a format allows 8 bits for R,G,B, and alpha channel
-        // use SRGB color space
-
-        if (availableFormat.format == vk::Format::eB8G8R8A8Srgb &&
-            availableFormat.colorSpace == vk::ColorSpaceKHR::eSrgbNonlinear)
-        {
-            return availableFormat;
-        }
-    }
-
-    // if nothing matches what we are looking for, just take what is available
-    return availableFormats[0];
+    // the export copy and damaged regions change every frame, so frames are only replayed without them
+    return m_winContext != nullptr && m_winContext->cacheStaticCommandBuffers &&
+           m_winContext->frameExportSocketPath.empty() && !m_winContext->damageTracking;
 }
 
 bool star::windowing::SwapChainRenderer::doesSwapChainSupportTransferOperations(
@@ -139,11 +200,10 @@ bool star::windowing::SwapChainRenderer::doesSwapChainSupportTransferOperations(
 
 vk::Format star::windowing::SwapChainRenderer::getColorAttachmentFormat(star::core::device::DeviceContext &device) const
 {
-    core::SwapChainSupportDetails swapChainSupport =
-        device.getDevice().getSwapchainSupport(m_winContext->surface.getVulkanSurface());
-
-    vk::SurfaceFormatKHR surfaceFormat = chooseSwapSurfaceFormat(swapChainSupport.formats);
-    return surfaceFormat.format;
+    // the swapchain made the choice, picking again here could disagree with it
+    assert(m_winContext->swapChainInfo.surfaceFormat.format != vk::Format::eUndefined &&
+           "Swapchain must be created before the renderer");
+    return m_winContext->swapChainInfo.surfaceFormat.format;
 }
 
 vk::Semaphore star::windowing::SwapChainRenderer::submitBuffer(
@@ -153,8 +213,16 @@ vk::Semaphore star::windowing::SwapChainRenderer::submitBuffer(
 {
     size_t frameIndex = static_cast<size_t>(frameTracker.getCurrent().getFrameInFlightIndex());
 
-    std::vector<vk::Semaphore> waitSemaphores = {*m_winContext->syncInfo.swapChainAcquireSemaphore};
-    std::vector<vk::PipelineStageFlags> waitStages = {vk::PipelineStageFlagBits::eColorAttachmentOutput};
+    const bool imageAcquired = m_winContext->syncInfo.imageAcquired;
+    std::vector<vk::Semaphore> waitSemaphores;
+    std::vector<vk::PipelineStageFlags> waitStages;
+    if (imageAcquired)
+    {
+        waitSemaphores.push_back(*m_winContext->syncInfo.swapChainAcquireSemaphore);
+        // a final compute pass is the first to touch the acquired image
+        waitStages.push_back(isComputingToSwapChain() ? vk::PipelineStageFlagBits::eComputeShader
+                                                      : vk::PipelineStageFlagBits::eColorAttachmentOutput);
+    }
 
     std::vector<vk::Semaphore> waitTimelines;
     std::vector<uint64_t> waitTimelinesValues;
@@ -186,20 +254,67 @@ vk::Semaphore star::windowing::SwapChainRenderer::submitBuffer(
     uint32_t waitSemaphoreCount = 0;
     common::helper::SafeCast<size_t, uint32_t>(waitSemaphores.size(), waitSemaphoreCount);
 
+    m_presentationSharedDeps.presentImage = imageAcquired;
+    if (!imageAcquired)
+    {
+        // nothing to draw to. The semaphores are still waited on and signaled so no binary semaphore is left signaled
+        // and work waiting on this frame does not stall, presentation takes the signal back without presenting
+        const auto skipInfo = vk::SubmitInfo()
+                                  .setWaitSemaphoreCount(waitSemaphoreCount)
+                                  .setPWaitSemaphores(waitSemaphores.data())
+                                  .setPWaitDstStageMask(waitStages.data())
+                                  .setSignalSemaphoreCount(1)
+                                  .setPSignalSemaphores(m_skippedFrameSemaphore.semaphore);
+        if (this->device->getDevice().getDefaultQueue(star::Queue_Type::Tpresent).getVulkanQueue().submit(
+                1, &skipInfo, VK_NULL_HANDLE) != vk::Result::eSuccess)
+        {
+            throw std::runtime_error("Failed to submit skipped frame");
+        }
+        return *m_skippedFrameSemaphore.semaphore;
+    }
+
     auto *signalSemaphore = &m_renderingContext.recordDependentSemaphores.get(
         this->imageAvailableSemaphores[frameTracker.getCurrent().getFinalTargetImageIndex()]);
     assert(signalSemaphore != nullptr &&
            "Signal semaphore was not properly added to the rendering context before record");
 
+    std::array<vk::Semaphore, 2> signalSemaphores{*signalSemaphore, VK_NULL_HANDLE};
+    std::array<uint64_t, 2> signalValues{0, 0};
+    vk::TimelineSemaphoreSubmitInfo timelineInfo{};
+    if (m_exportThisFrame)
+    {
+        // the exported timeline tells consumers when the copy into the export ring is done
+        signalSemaphores[1] = m_frameExporter->getSemaphore();
+        signalValues[1] = m_frameExporter->getSignalValue();
+        timelineInfo.setSignalSemaphoreValueCount(2).setPSignalSemaphoreValues(signalValues.data());
+    }
+
     vk::SubmitInfo submitInfo{};
     submitInfo.commandBufferCount = 1;
     submitInfo.pWaitSemaphores = waitSemaphores.data();
     submitInfo.waitSemaphoreCount = waitSemaphoreCount;
-    submitInfo.signalSemaphoreCount = 1;
-    submitInfo.pSignalSemaphores = signalSemaphore;
+    submitInfo.signalSemaphoreCount = m_exportThisFrame ? 2 : 1;
+    submitInfo.pSignalSemaphores = signalSemaphores.data();
+    submitInfo.pNext = m_exportThisFrame ? &timelineInfo : nullptr;
     submitInfo.pWaitDstStageMask = waitStages.data();
     submitInfo.pCommandBuffers = &buffer.buffer(frameIndex);
     submitInfo.commandBufferCount = 1;
+    if (m_cachedCommandPool)
+    {
+        submitInfo.pCommandBuffers = &getCachedCommandBuffer(frameTracker, frameIndex);
+    }
+
+    if (m_readbackConverter)
+    {
+        // the previous conversion into this frame's buffer has completed, hand it out before it is overwritten
+        uint64_t &pending = m_pendingReadbacks[frameIndex];
+        if (pending > m_lastDeliveredReadback && m_readbackCallback)
+        {
+            m_readbackCallback(m_readbackConverter->getFrame(device->getDevice(), static_cast<uint8_t>(frameIndex)));
+            m_lastDeliveredReadback = pending;
+        }
+        pending = ++m_readbackSequence;
+    }
 
     assert(m_winContext->syncInfo.imageAvailableFence != nullptr);
     const vk::Fence &fence = *m_winContext->syncInfo.imageAvailableFence;
@@ -212,7 +327,27 @@ vk::Semaphore star::windowing::SwapChainRenderer::submitBuffer(
         throw std::runtime_error("Failed to submit command buffer");
     }
 
+    if (m_exportThisFrame)
+    {
+        m_frameExporter->endFrame();
+    }
+
+    auto &startupTimings = m_winContext->startupTimings;
+    if (startupTimings.timeToFirstFrameSubmit.count() == 0.0)
+    {
+        startupTimings.timeToFirstFrameSubmit = std::chrono::steady_clock::now() - startupTimings.start;
+    }
+
     m_presentationSharedDeps.acquiredSwapChainImageIndex = frameTracker.getCurrent().getFinalTargetImageIndex();
+    m_presentationSharedDeps.presentRegions.clear();
+    if (m_winContext->damageTracking && m_winContext->incrementalPresent && !isComputingToSwapChain() &&
+        !m_damage.isFullPresent())
+    {
+        for (const auto &region : m_damage.getPresentRegions())
+        {
+            m_presentationSharedDeps.presentRegions.emplace_back(region.offset, region.extent, 0);
+        }
+    }
 
     m_renderingContext.recordDependentImage.get(m_renderToImages[frameIndex])
         ->setImageLayout(vk::ImageLayout::ePresentSrcKHR);
@@ -224,7 +359,7 @@ std::vector<star::StarTextures::Texture> star::windowing::SwapChainRenderer::cre
     star::core::device::DeviceContext &device, const uint8_t &numFramesInFlight)
 {
     std::vector<StarTextures::Texture> newRenderToImages = std::vector<StarTextures::Texture>();
-    const vk::Extent2D winResolution = m_winContext->window.getWindowFramebufferSize();
+    const vk::Extent2D winResolution = m_winContext->swapChainInfo.extent;
     const vk::Extent3D resolution =
         vk::Extent3D().setWidth(winResolution.width).setHeight(winResolution.height).setDepth(1);
 
@@ -302,7 +437,9 @@ vk::RenderingAttachmentInfo star::windowing::SwapChainRenderer::prepareDynamicRe
     colorAttachmentInfo.imageView =
         m_renderingContext.recordDependentImage.get(m_renderToImages[index])->getImageView();
     colorAttachmentInfo.imageLayout = vk::ImageLayout::eColorAttachmentOptimal;
-    colorAttachmentInfo.loadOp = vk::AttachmentLoadOp::eClear;
+    // with damage tracking, only the damaged regions were cleared and everything else keeps its previous contents
+    const bool keepContents = m_winContext->damageTracking && !m_damage.isFullRedraw();
+    colorAttachmentInfo.loadOp = keepContents ? vk::AttachmentLoadOp::eLoad : vk::AttachmentLoadOp::eClear;
     colorAttachmentInfo.storeOp = vk::AttachmentStoreOp::eStore;
     colorAttachmentInfo.clearValue = vk::ClearValue{vk::ClearValue{std::array<float, 4>{0.0f, 0.0f, 0.0f, 1.0f}}};
 
@@ -313,50 +450,148 @@ void star::windowing::SwapChainRenderer::recordCommandBuffer(vk::CommandBuffer &
                                                              const common::FrameTracker &frameTracker,
                                                              const uint64_t &frameIndex)
 {
-    auto barriers = getImageBarriersForThisFrame(frameTracker);
-    uint32_t numBarriers;
-    common::helper::SafeCast<size_t, uint32_t>(barriers.size(), numBarriers);
+    if (!m_winContext->syncInfo.imageAcquired)
+    {
+        // the frame is skipped, see submitBuffer
+        return;
+    }
 
-    commandBuffer.pipelineBarrier2(
-        vk::DependencyInfo().setImageMemoryBarrierCount(numBarriers).setPImageMemoryBarriers(barriers.data()));
+    if (isComputingToSwapChain())
+    {
+        // the compute pass writes every pixel, nothing is drawn or tracked underneath it
+        recordFinalComputePass(commandBuffer, frameTracker);
+    }
+    else
+    {
+        if (m_winContext->damageTracking)
+        {
+            m_damage.beginImage(frameTracker.getCurrent().getFinalTargetImageIndex());
+            publishPendingDamage();
+            recordDamageClears(commandBuffer, frameTracker);
+        }
+
+        auto barriers = getImageBarriersForThisFrame(frameTracker);
+        uint32_t numBarriers;
+        common::helper::SafeCast<size_t, uint32_t>(barriers.size(), numBarriers);
+
+        commandBuffer.pipelineBarrier2(
+            vk::DependencyInfo().setImageMemoryBarrierCount(numBarriers).setPImageMemoryBarriers(barriers.data()));
+
+        if (m_winContext->damageTracking && !m_damage.isFullRedraw())
+        {
+            // draws outside the damage only reproduce what is already there, unless objects set their own scissor
+            const vk::Rect2D bounds = m_damage.getRedrawBounds();
+            commandBuffer.setScissor(0, 1, &bounds);
+        }
+
+        this->DefaultRenderer::recordCommandBuffer(commandBuffer, frameTracker, frameIndex);
+    }
+
+    if (m_exportThisFrame)
+    {
+        const StarTextures::Texture *finalImage = m_renderingContext.recordDependentImage.get(
+            m_renderToImages[frameTracker.getCurrent().getFinalTargetImageIndex()]);
+        m_frameExporter->recordCopy(commandBuffer, finalImage->getVulkanImage(), m_winContext->swapChainInfo.extent,
+                                    vk::ImageLayout::ePresentSrcKHR);
+    }
 
-    this->DefaultRenderer::recordCommandBuffer(commandBuffer, frameTracker, frameIndex);
+    if (m_readbackConverter)
+    {
+        const StarTextures::Texture *finalImage = m_renderingContext.recordDependentImage.get(
+            m_renderToImages[frameTracker.getCurrent().getFinalTargetImageIndex()]);
+        m_readbackConverter->recordConversion(
+            commandBuffer, static_cast<uint8_t>(frameTracker.getCurrent().getFrameInFlightIndex()),
+            finalImage->getVulkanImage(), m_winContext->swapChainInfo.extent, vk::ImageLayout::ePresentSrcKHR);
+    }
 }
 
-std::vector<star::Handle> star::windowing::SwapChainRenderer::CreateSemaphores(
-    star::core::device::DeviceContext &context, const uint8_t &numToCreate, const bool &isTimeline)
+void star::windowing::SwapChainRenderer::recreateSwapChain(core::device::DeviceContext &context)
 {
-    auto semaphores = std::vector<Handle>(numToCreate);
+    assert(m_winContext != nullptr);
 
-    for (size_t i{0}; i < (size_t)numToCreate; i++)
+    // the swapchain controller waited for the device to go idle before replacing the swapchain, the previous images
+    // are no longer in use
+    m_swapChain = m_winContext->swapChainInfo.swapChain;
+    m_swapChainGeneration = m_winContext->swapChainInfo.generation;
+
+    auto newImages = createRenderToImages(context, numFramesInFlight);
+    if (newImages.size() != m_renderToImages.size())
     {
-        context.getEventBus().emit(core::device::system::event::ManagerRequest(
-            common::HandleTypeRegistry::instance().getType(core::device::manager::GetSemaphoreEventTypeName).value(),
-            core::device::manager::SemaphoreRequest{isTimeline}, semaphores[i]));
+        // every per image resource was sized for the first swapchain, see SwapChain::recreate
+        throw std::runtime_error("Number of swapchain images changed during recreation");
+    }
+
+    for (size_t i{0}; i < m_renderToImages.size(); i++)
+    {
+        StarTextures::Texture *image = m_renderingContext.recordDependentImage.get(m_renderToImages[i]);
+        image->cleanupRender(context.getDevice().getVulkanDevice());
+        *image = std::move(newImages[i]);
+    }
 
-        if (!semaphores[i].isInitialized())
+    if (getColorAttachmentFormat(context) != m_copyStageFormat)
+    {
+        // the format follows the final compute pass, see WindowingContext::computeToSwapChain, and the export ring and
+        // readback conversion were created for the previous one
+        cleanupCopyStages(context);
+        prepCopyStages(context);
+    }
+
+    // recorded commands reference the previous images
+    invalidateRecordedCommands();
+    m_damage.reset(static_cast<uint32_t>(m_renderToImages.size()), m_winContext->swapChainInfo.extent);
+    publishPendingDamage();
+}
+
+void star::windowing::SwapChainRenderer::prepCopyStages(core::device::DeviceContext &c)
+{
+    m_copyStageFormat = getColorAttachmentFormat(c);
+
+    if (!m_winContext->frameExportSocketPath.empty())
+    {
+        if (!doesSwapChainSupportTransferOperations(c))
         {
-            throw std::runtime_error("failed to create semaphores for a frame");
+            throw std::runtime_error("Frame export requires swapchain images which can be used as a transfer source");
         }
+
+        m_frameExporter = std::make_unique<FrameExporter>();
+        m_frameExporter->prepRender(c.getDevice(), m_winContext->swapChainInfo.extent, m_copyStageFormat,
+                                    m_winContext->frameExportRingSize, m_winContext->frameExportSocketPath);
     }
 
-    return semaphores;
+    if (m_winContext->readbackFormat != Readback_Format::disabled)
+    {
+        if (!doesSwapChainSupportTransferOperations(c))
+        {
+            throw std::runtime_error("Readback requires swapchain images which can be used as a transfer source");
+        }
+
+        vk::Extent2D readbackExtent = m_winContext->readbackExtent;
+        if (readbackExtent.width == 0 || readbackExtent.height == 0)
+        {
+            readbackExtent = m_winContext->swapChainInfo.extent;
+        }
+
+        m_readbackConverter = std::make_unique<ReadbackConverter>();
+        m_readbackConverter->prepRender(c.getDevice(), readbackExtent, m_winContext->readbackFormat, m_copyStageFormat,
+                                        numFramesInFlight);
+        m_pendingReadbacks.assign(numFramesInFlight, 0);
+    }
 }
 
-void star::windowing::SwapChainRenderer::recreateSwapChain()
+void star::windowing::SwapChainRenderer::cleanupCopyStages(core::device::DeviceContext &context)
 {
-    assert(m_winContext != nullptr);
+    if (m_frameExporter)
+    {
+        m_frameExporter->cleanupRender(context.getDevice());
+        m_frameExporter.reset();
+    }
 
-    int width = 0, height = 0;
-    // check for window minimization and wait for window size to no longer be 0
-    glfwGetFramebufferSize(m_winContext->window.getGLFWWindow(), &width, &height);
-    while (width == 0 || height == 0)
+    if (m_readbackConverter)
     {
-        glfwGetFramebufferSize(m_winContext->window.getGLFWWindow(), &width, &height);
-        glfwWaitEvents();
+        m_readbackConverter->cleanupRender(context.getDevice());
+        m_readbackConverter.reset();
+        m_pendingReadbacks.clear();
     }
-    // wait for device to finish any current actions
-    vkDeviceWaitIdle(this->device->getDevice().getVulkanDevice());
 }
 
 void star::windowing::SwapChainRenderer::prepareRenderingContext(core::device::DeviceContext &context)
@@ -364,6 +599,186 @@ void star::windowing::SwapChainRenderer::prepareRenderingContext(core::device::D
     addSemaphoresToRenderingContext(context);
 }
 
+void star::windowing::SwapChainRenderer::recordFinalComputePass(vk::CommandBuffer &commandBuffer,
+                                                                const common::FrameTracker &frameTracker)
+{
+    StarTextures::Texture *image = m_renderingContext.recordDependentImage.get(
+        m_renderToImages[frameTracker.getCurrent().getFinalTargetImageIndex()]);
+    const auto range = vk::ImageSubresourceRange()
+                           .setAspectMask(vk::ImageAspectFlagBits::eColor)
+                           .setBaseMipLevel(0)
+                           .setLevelCount(1)
+                           .setBaseArrayLayer(0)
+                           .setLayerCount(1);
+
+    // the acquire semaphore is waited on at the compute stage, the barrier chains onto that wait
+    const auto toGeneral = vk::ImageMemoryBarrier2()
+                               .setOldLayout(vk::ImageLayout::eUndefined)
+                               .setNewLayout(vk::ImageLayout::eGeneral)
+                               .setSrcStageMask(vk::PipelineStageFlagBits2::eComputeShader)
+                               .setSrcAccessMask(vk::AccessFlagBits2::eNone)
+                               .setDstStageMask(vk::PipelineStageFlagBits2::eComputeShader)
+                               .setDstAccessMask(vk::AccessFlagBits2::eShaderStorageWrite)
+                               .setSrcQueueFamilyIndex(vk::QueueFamilyIgnored)
+                               .setDstQueueFamilyIndex(vk::QueueFamilyIgnored)
+                               .setImage(image->getVulkanImage())
+                               .setSubresourceRange(range);
+    commandBuffer.pipelineBarrier2(
+        vk::DependencyInfo().setImageMemoryBarrierCount(1).setPImageMemoryBarriers(&toGeneral));
+
+    const ComputeTarget target{.image = image->getVulkanImage(),
+                               .view = image->getImageView(),
+                               .extent = m_winContext->swapChainInfo.extent,
+                               .format = m_winContext->swapChainInfo.surfaceFormat.format,
+                               .frameInFlightIndex =
+                                   static_cast<uint8_t>(frameTracker.getCurrent().getFrameInFlightIndex())};
+    m_finalComputePass(commandBuffer, target);
+
+    // export and readback copy from the image after this, so they are covered along with presentation
+    const auto toPresent = vk::ImageMemoryBarrier2()
+                               .setOldLayout(vk::ImageLayout::eGeneral)
+                               .setNewLayout(vk::ImageLayout::ePresentSrcKHR)
+                               .setSrcStageMask(vk::PipelineStageFlagBits2::eComputeShader)
+                               .setSrcAccessMask(vk::AccessFlagBits2::eShaderStorageWrite)
+                               .setDstStageMask(vk::PipelineStageFlagBits2::eAllCommands)
+                               .setDstAccessMask(vk::AccessFlagBits2::eMemoryRead)
+                               .setSrcQueueFamilyIndex(vk::QueueFamilyIgnored)
+                               .setDstQueueFamilyIndex(vk::QueueFamilyIgnored)
+                               .setImage(image->getVulkanImage())
+                               .setSubresourceRange(range);
+    commandBuffer.pipelineBarrier2(
+        vk::DependencyInfo().setImageMemoryBarrierCount(1).setPImageMemoryBarriers(&toPresent));
+}
+
+void star::windowing::SwapChainRenderer::recordDamageClears(vk::CommandBuffer &commandBuffer,
+                                                            const common::FrameTracker &frameTracker)
+{
+    if (m_damage.isFullRedraw() || m_damage.getRedrawRegions().empty())
+    {
+        return;
+    }
+
+    StarTextures::Texture *image = m_renderingContext.recordDependentImage.get(
+        m_renderToImages[frameTracker.getCurrent().getFinalTargetImageIndex()]);
+    const auto range = vk::ImageSubresourceRange()
+                           .setAspectMask(vk::ImageAspectFlagBits::eColor)
+                           .setBaseMipLevel(0)
+                           .setLevelCount(1)
+                           .setBaseArrayLayer(0)
+                           .setLayerCount(1);
+
+    // the previous contents must survive, so the transition starts from the image's current layout
+    const auto toAttachment = vk::ImageMemoryBarrier2()
+                                  .setOldLayout(image->getImageLayout())
+                                  .setNewLayout(vk::ImageLayout::eColorAttachmentOptimal)
+                                  .setSrcStageMask(vk::PipelineStageFlagBits2::eColorAttachmentOutput)
+                                  .setSrcAccessMask(vk::AccessFlagBits2::eNone)
+                                  .setDstStageMask(vk::PipelineStageFlagBits2::eColorAttachmentOutput)
+                                  .setDstAccessMask(vk::AccessFlagBits2::eColorAttachmentWrite)
+                                  .setSrcQueueFamilyIndex(vk::QueueFamilyIgnored)
+                                  .setDstQueueFamilyIndex(vk::QueueFamilyIgnored)
+                                  .setImage(image->getVulkanImage())
+                                  .setSubresourceRange(range);
+    commandBuffer.pipelineBarrier2(
+        vk::DependencyInfo().setImageMemoryBarrierCount(1).setPImageMemoryBarriers(&toAttachment));
+
+    // a clear load op only touches the render area, so each region gets a pass of its own
+    auto clearAttachment = prepareDynamicRenderingInfoColorAttachment(frameTracker);
+    clearAttachment.setLoadOp(vk::AttachmentLoadOp::eClear).setImageLayout(vk::ImageLayout::eColorAttachmentOptimal);
+    for (const auto &region : m_damage.getRedrawRegions())
+    {
+        commandBuffer.beginRendering(vk::RenderingInfo()
+                                         .setRenderArea(region)
+                                         .setLayerCount(1)
+                                         .setColorAttachmentCount(1)
+                                         .setPColorAttachments(&clearAttachment));
+        commandBuffer.endRendering();
+    }
+
+    const auto toPrevious = vk::ImageMemoryBarrier2()
+                                .setOldLayout(vk::ImageLayout::eColorAttachmentOptimal)
+                                .setNewLayout(image->getImageLayout())
+                                .setSrcStageMask(vk::PipelineStageFlagBits2::eColorAttachmentOutput)
+                                .setSrcAccessMask(vk::AccessFlagBits2::eColorAttachmentWrite)
+                                .setDstStageMask(vk::PipelineStageFlagBits2::eColorAttachmentOutput)
+                                .setDstAccessMask(vk::AccessFlagBits2::eColorAttachmentWrite |
+                                                  vk::AccessFlagBits2::eColorAttachmentRead)
+                                .setSrcQueueFamilyIndex(vk::QueueFamilyIgnored)
+                                .setDstQueueFamilyIndex(vk::QueueFamilyIgnored)
+                                .setImage(image->getVulkanImage())
+                                .setSubresourceRange(range);
+    commandBuffer.pipelineBarrier2(
+        vk::DependencyInfo().setImageMemoryBarrierCount(1).setPImageMemoryBarriers(&toPrevious));
+}
+
+void star::windowing::SwapChainRenderer::prepCachedCommandBuffers(core::device::DeviceContext &context)
+{
+    const vk::PhysicalDevice &physicalDevice = context.getDevice().getPhysicalDevice();
+    const vk::SurfaceKHR &surface = m_winContext->surface.getVulkanSurface();
+
+    // submissions go to the present queue, which lives in the first graphics family able to present to the surface
+    std::optional<uint32_t> queueFamily;
+    const auto families = physicalDevice.getQueueFamilyProperties();
+    for (uint32_t i = 0; i < families.size() && !queueFamily.has_value(); i++)
+    {
+        if ((families[i].queueFlags & vk::QueueFlagBits::eGraphics) && physicalDevice.getSurfaceSupportKHR(i, surface))
+        {
+            queueFamily = i;
+        }
+    }
+    if (!queueFamily.has_value())
+    {
+        throw std::runtime_error("Failed to find a queue family for cached command buffers");
+    }
+
+    m_cachedCommandPool = context.getDevice().getVulkanDevice().createCommandPool(
+        vk::CommandPoolCreateInfo()
+            .setFlags(vk::CommandPoolCreateFlagBits::eResetCommandBuffer)
+            .setQueueFamilyIndex(queueFamily.value()));
+
+    const uint32_t numBuffers = static_cast<uint32_t>(m_renderToImages.size()) * numFramesInFlight;
+    m_cachedCommandBuffers = context.getDevice().getVulkanDevice().allocateCommandBuffers(
+        vk::CommandBufferAllocateInfo()
+            .setCommandPool(m_cachedCommandPool)
+            .setLevel(vk::CommandBufferLevel::ePrimary)
+            .setCommandBufferCount(numBuffers));
+    m_cachedCommandBuffersValid.assign(numBuffers, false);
+}
+
+void star::windowing::SwapChainRenderer::cleanupCachedCommandBuffers(core::device::DeviceContext &context)
+{
+    if (m_cachedCommandPool)
+    {
+        // command buffers are freed along with their pool
+        context.getDevice().getVulkanDevice().destroyCommandPool(m_cachedCommandPool);
+        m_cachedCommandPool = VK_NULL_HANDLE;
+    }
+    m_cachedCommandBuffers.clear();
+    m_cachedCommandBuffersValid.clear();
+}
+
+vk::CommandBuffer &star::windowing::SwapChainRenderer::getCachedCommandBuffer(const common::FrameTracker &frameTracker,
+                                                                             const uint64_t &frameIndex)
+{
+    const size_t index = static_cast<size_t>(frameTracker.getCurrent().getFinalTargetImageIndex()) * numFramesInFlight +
+                         frameTracker.getCurrent().getFrameInFlightIndex();
+    assert(index < m_cachedCommandBuffers.size());
+
+    vk::CommandBuffer &commandBuffer = m_cachedCommandBuffers[index];
+    if (!m_cachedCommandBuffersValid[index])
+    {
+        // the previous submission of this buffer used the same frame in flight, which has been waited on
+        commandBuffer.reset();
+        commandBuffer.begin(vk::CommandBufferBeginInfo());
+        recordCommandBuffer(commandBuffer, frameTracker, frameIndex);
+        commandBuffer.end();
+
+        m_cachedCommandBuffersValid[index] = true;
+    }
+
+    return commandBuffer;
+}
+
 void star::windowing::SwapChainRenderer::addSemaphoresToRenderingContext(core::device::DeviceContext &context)
 {
     for (const auto &semaphore : this->graphicsDoneSemaphoresExternalUse)
@@ -1,11 +1,10 @@
 #include "star_windowing/Swapchain.hpp"
 
-#include <star_common/HandleTypeRegistry.hpp>
-#include <starlight/core/device/managers/Fence.hpp>
-#include <starlight/core/device/managers/Semaphore.hpp>
-#include <starlight/core/device/system/event/ManagerRequest.hpp>
+#include "star_windowing/SplashPresenter.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <limits>
 #include <stdexcept>
 
 namespace star::windowing
@@ -29,76 +28,100 @@ void ResetFence(core::device::StarDevice &device, vk::Fence &fence)
     }
 }
 
-void CreateFences(common::EventBus &eventBus, const size_t &numToCreate, std::vector<star::Handle> &newHandles,
-                  std::vector<vk::Fence *> &newFences)
+SwapChain::SwapChain(WindowingContext *winContext) : m_winContext(winContext)
 {
-    newHandles.resize(numToCreate);
-    newFences.resize(numToCreate);
+}
 
-    for (size_t i{0}; i < numToCreate; i++)
+void SwapChain::prepRender(core::device::StarDevice &device, common::EventBus &eventBus,
+                           common::FrameTracker &deviceFrameTracker)
+{
+    // take over from the splash swapchain if one was presenting during startup
+    if (m_winContext->splashPresenter != nullptr)
     {
-        void *r = nullptr;
-        eventBus.emit(core::device::system::event::ManagerRequest(
-            common::HandleTypeRegistry::instance().getTypeGuaranteedExist(core::device::manager::GetFenceEventName),
-            core::device::manager::FenceRequest{true}, newHandles[i], &r));
-        if (r == nullptr)
-        {
-            throw std::runtime_error("Manager did not provide fence");
-        }
-        newFences[i] = &static_cast<core::device::manager::FenceRecord *>(r)->fence;
+        m_winContext->splashPresenter->releaseToContext();
+    }
+    m_swapChain = createSwapchain(device, deviceFrameTracker, m_winContext->splashSwapChain);
+    if (m_winContext->splashSwapChain)
+    {
+        device.getVulkanDevice().destroySwapchainKHR(m_winContext->splashSwapChain);
+        m_winContext->splashSwapChain = VK_NULL_HANDLE;
+    }
+    publishSwapChain();
+    m_numImages = device.getVulkanDevice().getSwapchainImagesKHR(m_swapChain).size();
+    m_imagesInFlight.resize(deviceFrameTracker.getSetup().getNumUniqueTargetFramesForFinalization());
+
+    m_inFlightFences = m_winContext->syncObjects.acquireFences(device, eventBus,
+                                                               deviceFrameTracker.getSetup().getNumFramesInFlight());
+    for (const auto &fence : m_inFlightFences)
+    {
+        m_fenceStorage.manualInsert(fence.handle, *fence.fence);
     }
+
+    m_imageAcquireSemaphores = m_winContext->syncObjects.acquireSemaphores(
+        device, eventBus, deviceFrameTracker.getSetup().getNumUniqueTargetFramesForFinalization());
 }
 
-void CreateSemaphores(common::EventBus &eventBus, const size_t &numToCreate, std::vector<Handle> &newHandles,
-                      std::vector<vk::Semaphore *> &newSemaphores)
+void SwapChain::cleanupRender(core::device::StarDevice &device)
 {
-    newHandles.resize(numToCreate);
-    newSemaphores.resize(numToCreate);
-
-    for (size_t i{0}; i < numToCreate; i++)
+    // an acquire semaphore is done with once the frame in flight which waited on it completes
+    for (size_t i{0}; i < m_imageAcquireSemaphores.size(); i++)
+    {
+        m_winContext->syncObjects.releaseSemaphore(
+            m_imageAcquireSemaphores[i], i < m_inFlightFences.size() ? *m_inFlightFences[i].fence : VK_NULL_HANDLE);
+    }
+    for (const auto &fence : m_inFlightFences)
     {
-        void *r = nullptr;
-        eventBus.emit(core::device::system::event::ManagerRequest{
-            common::HandleTypeRegistry::instance().getTypeGuaranteedExist(
-                core::device::manager::GetSemaphoreEventTypeName),
-            core::device::manager::SemaphoreRequest{false}, newHandles[i], &r});
+        m_winContext->syncObjects.releaseFence(fence);
+    }
+    m_imageAcquireSemaphores.clear();
+    m_inFlightFences.clear();
+    m_imagesInFlight.clear();
+    m_fenceStorage = star::core::MappedHandleContainer<vk::Fence>{common::special_types::FenceTypeName};
 
-        if (r == nullptr)
-        {
-            throw std::runtime_error("Manager did not provide semaphore");
-        }
-        newSemaphores[i] = &static_cast<core::device::manager::SemaphoreRecord *>(r)->semaphore;
+    if (m_winContext->splashSwapChain != VK_NULL_HANDLE)
+    {
+        device.getVulkanDevice().destroySwapchainKHR(m_winContext->splashSwapChain);
+        m_winContext->splashSwapChain = VK_NULL_HANDLE;
+    }
+    if (m_swapChain != VK_NULL_HANDLE)
+    {
+        device.getVulkanDevice().destroySwapchainKHR(m_swapChain);
+        m_swapChain = VK_NULL_HANDLE;
     }
 }
 
-SwapChain::SwapChain(WindowingContext *winContext) : m_winContext(winContext)
+void SwapChain::recreate(core::device::StarDevice &device, common::FrameTracker &deviceFrameTracker)
 {
-}
+    assert(m_swapChain && "Swapchain must be created before it can be recreated");
 
-void SwapChain::prepRender(core::device::StarDevice &device, common::EventBus &eventBus,
-                           common::FrameTracker &deviceFrameTracker)
-{
-    m_swapChain = createSwapchain(device, deviceFrameTracker);
-    m_imagesInFlight.resize(deviceFrameTracker.getSetup().getNumUniqueTargetFramesForFinalization());
+    // images of the old swapchain may still be in use by submitted work
+    device.getVulkanDevice().waitIdle();
 
-    CreateFences(eventBus, deviceFrameTracker.getSetup().getNumFramesInFlight(), m_inFlightFences, m_inFlightFencesRaw);
+    const vk::SwapchainKHR oldSwapChain = m_swapChain;
+    m_swapChain = createSwapchain(device, deviceFrameTracker, oldSwapChain);
+    device.getVulkanDevice().destroySwapchainKHR(oldSwapChain);
 
-    for (size_t i{0}; i < m_inFlightFencesRaw.size(); i++)
+    // everything indexed by swapchain image is sized once, for the number of images the first swapchain had
+    if (device.getVulkanDevice().getSwapchainImagesKHR(m_swapChain).size() != m_numImages)
     {
-        m_fenceStorage.manualInsert(m_inFlightFences[i], *m_inFlightFencesRaw[i]);
+        throw std::runtime_error("Number of swapchain images changed during recreation");
     }
 
-    CreateSemaphores(eventBus, deviceFrameTracker.getSetup().getNumUniqueTargetFramesForFinalization(),
-                     m_imageAcquireSemaphores, m_imageAcquireSemaphoresRaw);
+    // image indices restart with the new swapchain, nothing is in flight after the wait
+    std::fill(m_imagesInFlight.begin(), m_imagesInFlight.end(), Handle());
+
+    publishSwapChain();
 }
 
-void SwapChain::cleanupRender(core::device::StarDevice &device)
+void SwapChain::publishSwapChain()
 {
-    if (m_swapChain != VK_NULL_HANDLE)
-    {
-        device.getVulkanDevice().destroySwapchainKHR(m_swapChain);
-        m_swapChain = VK_NULL_HANDLE;
-    }
+    assert(m_winContext != nullptr);
+
+    m_winContext->swapChainInfo.swapChain = m_swapChain;
+    m_winContext->swapChainInfo.surfaceFormat = m_surfaceFormat;
+    m_winContext->swapChainInfo.extent = m_extent;
+    m_winContext->swapChainInfo.storageUsage = m_storageUsage;
+    m_winContext->swapChainInfo.generation++;
 }
 
 vk::ResultValue<uint32_t> SwapChain::acquireNextSwapChainImage(core::device::StarDevice &device,
@@ -106,40 +129,59 @@ vk::ResultValue<uint32_t> SwapChain::acquireNextSwapChainImage(core::device::Sta
 {
     assert(m_swapChain && "Swapchain must be created before use");
     const size_t &frameIndex = frameTracker.getCurrent().getFrameInFlightIndex();
+    m_winContext->syncInfo.imageAcquired = false;
 
     // wait for fences before acquire
     waitForPreviousFrameInFlightToBeDone(device, frameTracker.getCurrent().getFrameInFlightIndex());
 
-    auto result =
-        device.getVulkanDevice().acquireNextImageKHR(m_swapChain, UINT64_MAX, *m_imageAcquireSemaphoresRaw[frameIndex]);
+    vk::ResultValue<uint32_t> result{vk::Result::eErrorOutOfDateKHR, 0};
+    try
+    {
+        result = device.getVulkanDevice().acquireNextImageKHR(m_swapChain, UINT64_MAX,
+                                                              *m_imageAcquireSemaphores[frameIndex].semaphore);
+    }
+    catch (const vk::OutOfDateKHRError &)
+    {
+        // nothing was acquired and the semaphore is untouched, the caller needs to recreate before trying again
+        return result;
+    }
 
     waitForPreviousFrameToBeDoneWithSwapChainImage(device, result.value);
 
     {
         const size_t acqImage = static_cast<size_t>(result.value);
         // mark as in use
-        m_imagesInFlight[acqImage] = m_inFlightFences[frameIndex];
+        m_imagesInFlight[acqImage] = m_inFlightFences[frameIndex].handle;
 
         vk::Fence &fence = m_fenceStorage.get(m_imagesInFlight[acqImage]);
         ResetFence(device, fence);
 
         m_winContext->syncInfo.imageAvailableFence = &fence;
-        m_winContext->syncInfo.swapChainAcquireSemaphore = m_imageAcquireSemaphoresRaw[frameIndex];
+        m_winContext->syncInfo.swapChainAcquireSemaphore = m_imageAcquireSemaphores[frameIndex].semaphore;
+        m_winContext->syncInfo.imageAcquired = true;
     }
 
     return result;
 }
 
-uint8_t SwapChain::getNumImagesGuaranteedInSwapchain(core::device::StarDevice &device) const
+void SwapChain::skipNextSwapChainImage(core::device::StarDevice &device, const common::FrameTracker &frameTracker)
 {
     assert(m_winContext != nullptr);
 
-    const auto caps = device.getPhysicalDevice().getSurfaceCapabilities2KHR(m_winContext->surface.getVulkanSurface());
+    // the frame's command buffers are still recorded, which must wait for their previous submission to be done
+    waitForPreviousFrameInFlightToBeDone(device, frameTracker.getCurrent().getFrameInFlightIndex());
+    m_winContext->syncInfo.imageAcquired = false;
+}
 
-    return chooseNumOfImages(caps);
+uint8_t SwapChain::getNumImagesGuaranteedInSwapchain(core::device::StarDevice &device) const
+{
+    assert(m_winContext != nullptr);
+
+    return chooseNumOfImages(m_winContext->surface.getCapabilities(device.getPhysicalDevice()));
 }
 
-vk::SwapchainKHR SwapChain::createSwapchain(core::device::StarDevice &device, common::FrameTracker &deviceFrameTracker)
+vk::SwapchainKHR SwapChain::createSwapchain(core::device::StarDevice &device, common::FrameTracker &deviceFrameTracker,
+                                            vk::SwapchainKHR oldSwapChain)
 {
     vk::Extent2D resolution{};
     vk::SurfaceFormatKHR format{};
@@ -147,7 +189,23 @@ vk::SwapchainKHR SwapChain::createSwapchain(core::device::StarDevice &device, co
     vk::PresentModeKHR presentMode{};
     vk::SurfaceTransformFlagBitsKHR transform{};
     bool doesSupportTransfer{false};
-    gatherSwapchainDependencies(device, resolution, format, presentMode, transform, numImages, doesSupportTransfer);
+    bool doesSupportStorage{false};
+    gatherSwapchainDependencies(device, resolution, format, presentMode, transform, numImages, doesSupportTransfer,
+                                doesSupportStorage);
+
+    vk::ImageUsageFlags usage = vk::ImageUsageFlagBits::eColorAttachment;
+    if (doesSupportTransfer)
+    {
+        usage |= vk::ImageUsageFlagBits::eTransferSrc;
+    }
+    if (doesSupportStorage)
+    {
+        usage |= vk::ImageUsageFlagBits::eStorage;
+    }
+    m_surfaceFormat = format;
+    m_extent = resolution;
+    m_storageUsage = doesSupportStorage;
+    m_storageRequested = wantsStorageUsage();
 
     std::vector<uint32_t> queueFamilyIndices = device.getQueueOwnershipTracker().getAllQueueFamilyIndices();
 
@@ -159,9 +217,7 @@ vk::SwapchainKHR SwapChain::createSwapchain(core::device::StarDevice &device, co
             .setImageColorSpace(format.colorSpace)
             .setImageExtent(resolution)
             .setImageArrayLayers(1)
-            .setImageUsage(doesSupportTransfer
-                               ? (vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc)
-                               : vk::ImageUsageFlagBits::eColorAttachment)
+            .setImageUsage(usage)
             .setImageSharingMode(queueFamilyIndices.size() > 1 ? vk::SharingMode::eConcurrent
                                                                : vk::SharingMode::eExclusive)
             .setQueueFamilyIndexCount(queueFamilyIndices.size() > 1 ? (uint32_t)queueFamilyIndices.size() : 0)
@@ -170,14 +226,14 @@ vk::SwapchainKHR SwapChain::createSwapchain(core::device::StarDevice &device, co
             .setCompositeAlpha(vk::CompositeAlphaFlagBitsKHR::eOpaque)
             .setPresentMode(presentMode)
             .setClipped(VK_TRUE)
-            .setOldSwapchain(VK_NULL_HANDLE);
+            .setOldSwapchain(oldSwapChain);
 
     return device.getVulkanDevice().createSwapchainKHR(createInfo);
 }
 
 void SwapChain::waitForPreviousFrameInFlightToBeDone(core::device::StarDevice &device, const uint32_t &imageIndex)
 {
-    WaitForFence(device, *m_inFlightFencesRaw[imageIndex]);
+    WaitForFence(device, *m_inFlightFences[imageIndex].fence);
 }
 
 void SwapChain::waitForPreviousFrameToBeDoneWithSwapChainImage(core::device::StarDevice &device,
@@ -194,15 +250,22 @@ void SwapChain::gatherSwapchainDependencies(core::device::StarDevice &device, vk
                                             vk::SurfaceFormatKHR &selectedSurfaceFormat,
                                             vk::PresentModeKHR &selectedPresentMode,
                                             vk::SurfaceTransformFlagBitsKHR &selectedTransform,
-                                            uint8_t &selectedNumImages, bool &doesSupportTransfer) const
+                                            uint8_t &selectedNumImages, bool &doesSupportTransfer,
+                                            bool &doesSupportStorage) const
 {
     assert(m_winContext != nullptr);
-    const vk::SurfaceCapabilities2KHR caps =
-        device.getPhysicalDevice().getSurfaceCapabilities2KHR(m_winContext->surface.getVulkanSurface());
+    // the extent changes with the window, this always needs a fresh query
+    const vk::SurfaceCapabilities2KHR &caps = m_winContext->surface.refreshCapabilities(device.getPhysicalDevice());
     const auto swapSupport = device.getSwapchainSupport(m_winContext->surface.getVulkanSurface());
 
     selectedResolution = chooseSwapChainExtent(caps);
-    selectedSurfaceFormat = chooseSurfaceFormat(swapSupport);
+    // the raster path writes linear color and relies on an sRGB format, only a compute pass does its own encoding
+    doesSupportStorage = wantsStorageUsage() &&
+                         chooseStorageSurfaceFormat(device, swapSupport, caps, selectedSurfaceFormat);
+    if (!doesSupportStorage)
+    {
+        selectedSurfaceFormat = chooseSurfaceFormat(swapSupport);
+    }
     selectedPresentMode = choosePresentationMode(swapSupport);
     selectedNumImages = chooseNumOfImages(caps);
     selectedTransform = caps.surfaceCapabilities.currentTransform;
@@ -221,6 +284,12 @@ vk::Extent2D SwapChain::chooseSwapChainExtent(const vk::SurfaceCapabilities2KHR
 {
     assert(m_winContext != nullptr);
 
+    // a defined current extent must be matched, fullscreen surfaces report the size of the monitor's video mode
+    if (caps.surfaceCapabilities.currentExtent.width != std::numeric_limits<uint32_t>::max())
+    {
+        return caps.surfaceCapabilities.currentExtent;
+    }
+
     auto selectedResolution = m_winContext->window.getWindowFramebufferSize();
     selectedResolution.width = std::clamp(selectedResolution.width, caps.surfaceCapabilities.minImageExtent.width,
                                           caps.surfaceCapabilities.maxImageExtent.width);
@@ -252,6 +321,40 @@ vk::SurfaceFormatKHR SwapChain::chooseSurfaceFormat(const core::SwapChainSupport
     return supportDetails.formats.front();
 }
 
+bool SwapChain::chooseStorageSurfaceFormat(core::device::StarDevice &device,
+                                           const core::SwapChainSupportDetails &supportDetails,
+                                           const vk::SurfaceCapabilities2KHR &caps,
+                                           vk::SurfaceFormatKHR &selected) const
+{
+    if (!(caps.surfaceCapabilities.supportedUsageFlags & vk::ImageUsageFlagBits::eStorage))
+    {
+        return false;
+    }
+
+    // sRGB formats can rarely be used for storage, the shader encodes instead and the UNORM image is still displayed
+    // with the sRGB color space
+    for (const vk::Format candidate : {vk::Format::eB8G8R8A8Unorm, vk::Format::eR8G8B8A8Unorm})
+    {
+        const vk::FormatProperties properties = device.getPhysicalDevice().getFormatProperties(candidate);
+        if (!(properties.optimalTilingFeatures & vk::FormatFeatureFlagBits::eStorageImage))
+        {
+            continue;
+        }
+
+        for (const auto &availableFormat : supportDetails.formats)
+        {
+            if (availableFormat.format == candidate &&
+                availableFormat.colorSpace == vk::ColorSpaceKHR::eSrgbNonlinear)
+            {
+                selected = availableFormat;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
 uint8_t SwapChain::chooseNumOfImages(const vk::SurfaceCapabilities2KHR &caps) const
 {
     const auto min = (uint8_t)caps.surfaceCapabilities.minImageCount;
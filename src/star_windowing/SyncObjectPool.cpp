@@ -0,0 +1,128 @@
+#include "star_windowing/SyncObjectPool.hpp"
+
+#include <star_common/HandleTypeRegistry.hpp>
+#include <starlight/core/device/managers/Fence.hpp>
+#include <starlight/core/device/managers/Semaphore.hpp>
+#include <starlight/core/device/system/event/ManagerRequest.hpp>
+
+#include <stdexcept>
+
+namespace star::windowing
+{
+std::vector<SyncObjectPool::Fence> SyncObjectPool::acquireFences(core::device::StarDevice &device,
+                                                                 common::EventBus &eventBus, const size_t &numFences)
+{
+    collectRetired(device);
+
+    if (m_freeFences.size() < numFences)
+    {
+        createFences(eventBus, GetBatchedCount(numFences - m_freeFences.size()));
+    }
+
+    std::vector<Fence> fences(m_freeFences.end() - numFences, m_freeFences.end());
+    m_freeFences.resize(m_freeFences.size() - numFences);
+    return fences;
+}
+
+std::vector<SyncObjectPool::Semaphore> SyncObjectPool::acquireSemaphores(core::device::StarDevice &device,
+                                                                         common::EventBus &eventBus,
+                                                                         const size_t &numSemaphores)
+{
+    collectRetired(device);
+
+    if (m_freeSemaphores.size() < numSemaphores)
+    {
+        createSemaphores(eventBus, GetBatchedCount(numSemaphores - m_freeSemaphores.size()));
+    }
+
+    std::vector<Semaphore> semaphores(m_freeSemaphores.end() - numSemaphores, m_freeSemaphores.end());
+    m_freeSemaphores.resize(m_freeSemaphores.size() - numSemaphores);
+    return semaphores;
+}
+
+void SyncObjectPool::releaseFence(const Fence &fence)
+{
+    m_retiringFences.push_back(fence);
+}
+
+void SyncObjectPool::releaseSemaphore(const Semaphore &semaphore, const vk::Fence &retiredBy)
+{
+    if (retiredBy == VK_NULL_HANDLE)
+    {
+        m_freeSemaphores.push_back(semaphore);
+        return;
+    }
+
+    m_retiringSemaphores.push_back(RetiringSemaphore{.semaphore = semaphore, .retiredBy = retiredBy});
+}
+
+void SyncObjectPool::collectRetired(core::device::StarDevice &device)
+{
+    const vk::Device &vkDevice = device.getVulkanDevice();
+
+    // a fence which was reset but never submitted again stays here, it would never signal for a new owner either
+    for (size_t i = m_retiringFences.size(); i > 0; i--)
+    {
+        if (vkDevice.getFenceStatus(*m_retiringFences[i - 1].fence) == vk::Result::eSuccess)
+        {
+            m_freeFences.push_back(m_retiringFences[i - 1]);
+            m_retiringFences.erase(m_retiringFences.begin() + (i - 1));
+        }
+    }
+
+    for (size_t i = m_retiringSemaphores.size(); i > 0; i--)
+    {
+        if (vkDevice.getFenceStatus(m_retiringSemaphores[i - 1].retiredBy) == vk::Result::eSuccess)
+        {
+            m_freeSemaphores.push_back(m_retiringSemaphores[i - 1].semaphore);
+            m_retiringSemaphores.erase(m_retiringSemaphores.begin() + (i - 1));
+        }
+    }
+}
+
+void SyncObjectPool::createFences(common::EventBus &eventBus, const size_t &numFences)
+{
+    for (size_t i{0}; i < numFences; i++)
+    {
+        Fence fence;
+        void *r = nullptr;
+        eventBus.emit(core::device::system::event::ManagerRequest(
+            common::HandleTypeRegistry::instance().getTypeGuaranteedExist(core::device::manager::GetFenceEventName),
+            core::device::manager::FenceRequest{true}, fence.handle, &r));
+        if (r == nullptr)
+        {
+            throw std::runtime_error("Manager did not provide fence");
+        }
+        fence.fence = &static_cast<core::device::manager::FenceRecord *>(r)->fence;
+
+        m_freeFences.push_back(fence);
+        m_numCreatedFences++;
+    }
+}
+
+void SyncObjectPool::createSemaphores(common::EventBus &eventBus, const size_t &numSemaphores)
+{
+    for (size_t i{0}; i < numSemaphores; i++)
+    {
+        Semaphore semaphore;
+        void *r = nullptr;
+        eventBus.emit(core::device::system::event::ManagerRequest{
+            common::HandleTypeRegistry::instance().getTypeGuaranteedExist(
+                core::device::manager::GetSemaphoreEventTypeName),
+            core::device::manager::SemaphoreRequest{false}, semaphore.handle, &r});
+        if (r == nullptr)
+        {
+            throw std::runtime_error("Manager did not provide semaphore");
+        }
+        semaphore.semaphore = &static_cast<core::device::manager::SemaphoreRecord *>(r)->semaphore;
+
+        m_freeSemaphores.push_back(semaphore);
+        m_numCreatedSemaphores++;
+    }
+}
+
+size_t SyncObjectPool::GetBatchedCount(const size_t &shortfall)
+{
+    return ((shortfall + BatchSize - 1) / BatchSize) * BatchSize;
+}
+} // namespace star::windowing
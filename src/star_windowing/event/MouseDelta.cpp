@@ -0,0 +1,9 @@
+#include "star_windowing/event/MouseDelta.hpp"
+
+namespace star::windowing::event
+{
+MouseDelta::MouseDelta(double xdelta, double ydelta)
+    : common::IEvent(GetRegisteredType()), m_xdelta(xdelta), m_ydelta(ydelta)
+{
+}
+} // namespace star::windowing::event
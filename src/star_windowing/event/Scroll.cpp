@@ -0,0 +1,9 @@
+#include "star_windowing/event/Scroll.hpp"
+
+namespace star::windowing::event
+{
+Scroll::Scroll(double xoffset, double yoffset)
+    : common::IEvent(GetRegisteredType()), m_xoffset(xoffset), m_yoffset(yoffset)
+{
+}
+} // namespace star::windowing::event
@@ -1,30 +1,67 @@
 #include "star_windowing/policy/EngineInitPolicy.hpp"
 
+#include "star_windowing/FrameExporter.hpp"
+#include "star_windowing/RenderThread.hpp"
+#include "star_windowing/SplashPresenter.hpp"
 #include "star_windowing/SwapChainRenderer.hpp"
 #include "star_windowing/service/SwapChainControllerService.hpp"
 #include <starlight/common/ConfigFile.hpp>
 
 #include <GLFW/glfw3.h>
 
+#include <chrono>
+#include <future>
+
 namespace star::windowing
 {
 core::RenderingInstance EngineInitPolicy::createRenderingInstance(std::string appName)
 {
-    glfwInit();
+    using Clock = std::chrono::steady_clock;
+    auto &timings = m_winContext.startupTimings;
+    timings.start = Clock::now();
+
+    // with a dedicated render thread the engine runs on it, but GLFW still belongs to the main thread
+    RenderThread::RunOnMainThread([]() { StarWindow::InitGLFW(); });
+    timings.glfwInit = Clock::now() - timings.start;
 
     auto extensions = getRequiredDisplayExtensions();
     extensions.push_back(VK_KHR_GET_SURFACE_CAPABILITIES_2_EXTENSION_NAME);
-    core::RenderingInstance instance{appName, extensions};
 
-    m_winContext.window = createWindow();
+    // the instance does not depend on the window, so build it while the main thread creates the window. Physical
+    // devices are enumerated as well to get driver loading out of the way before the device is created.
+    auto pendingInstance = std::async(std::launch::async, [appName = std::move(appName),
+                                                           extensions = std::move(extensions), &timings]() {
+        const auto instanceStart = Clock::now();
+
+        core::RenderingInstance instance{appName, extensions};
+        instance.getVulkanInstance().enumeratePhysicalDevices();
+
+        timings.instanceCreation = Clock::now() - instanceStart;
+        return instance;
+    });
+
+    // GLFW windows must be created on the main thread
+    const auto windowStart = Clock::now();
+    RenderThread::RunOnMainThread([this]() { m_winContext.window = createWindow(); });
+    if (m_winContext.threadingMode == Threading_Mode::single_thread && m_winContext.refreshFrame)
+    {
+        // only the pumping thread runs the refresh callback, which with a render thread is not the one rendering
+        m_winContext.window.setRefreshCallback(m_winContext.refreshFrame);
+    }
+    timings.windowCreation = Clock::now() - windowStart;
+
+    core::RenderingInstance instance = pendingInstance.get();
+
+    const auto surfaceStart = Clock::now();
     m_winContext.surface = createRenderingSurface(instance.getVulkanInstance(), m_winContext.window);
+    timings.surfaceCreation = Clock::now() - surfaceStart;
 
     return instance;
 }
 
 void EngineInitPolicy::cleanup(core::RenderingInstance &instance)
 {
-    m_winContext.window.cleanupRender();
+    RenderThread::RunOnMainThread([this]() { m_winContext.window.cleanupRender(); });
     m_winContext.surface.cleanupRender(instance.getVulkanInstance());
 }
 
@@ -32,9 +69,40 @@ core::device::StarDevice EngineInitPolicy::createNewDevice(
     core::RenderingInstance &renderingInstance, std::set<star::Rendering_Features> &engineRenderingFeatures,
     std::set<Rendering_Device_Features> &engineRenderingDeviceFeatures)
 {
+    const auto deviceStart = std::chrono::steady_clock::now();
+
+    std::vector<const char *> deviceExtensions{VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+    if (!m_winContext.frameExportSocketPath.empty())
+    {
+        const auto exportExtensions = FrameExporter::GetRequiredDeviceExtensions();
+        deviceExtensions.insert(deviceExtensions.end(), exportExtensions.begin(), exportExtensions.end());
+    }
+    if (m_winContext.incrementalPresent)
+    {
+        deviceExtensions.push_back(VK_KHR_INCREMENTAL_PRESENT_EXTENSION_NAME);
+    }
+
     vk::SurfaceKHR vkSurface = m_winContext.surface.getVulkanSurface();
-    return core::device::StarDevice(renderingInstance, engineRenderingFeatures, engineRenderingDeviceFeatures,
-                                    {VK_KHR_SWAPCHAIN_EXTENSION_NAME}, &vkSurface);
+    core::device::StarDevice device(renderingInstance, engineRenderingFeatures, engineRenderingDeviceFeatures,
+                                    deviceExtensions, &vkSurface);
+
+    // prime the capability cache, frame tracking setup and the swapchain need the image counts next
+    m_winContext.surface.getCapabilities(device.getPhysicalDevice());
+
+    // the splash is not part of bringing up the device
+    m_winContext.startupTimings.deviceCreation = std::chrono::steady_clock::now() - deviceStart;
+
+    // the renderer and scene are still far from ready, show something until the swapchain takes over. If anything
+    // fails before then the presenter releases its handles on destruction
+    if (m_winContext.presentSplashDuringInit)
+    {
+        m_splash = std::make_unique<SplashPresenter>(m_winContext);
+        m_splash->setClearColor(m_winContext.splashClearColor);
+        m_splash->prepRender(device);
+        m_splash->startPresenting();
+    }
+
+    return device;
 }
 
 RenderingSurface EngineInitPolicy::createRenderingSurface(vk::Instance instance, StarWindow &window) const
@@ -56,7 +124,14 @@ StarWindow EngineInitPolicy::createWindow() const
     int height{std::stoi(star::ConfigFile::getSetting(Config_Settings::resolution_y))};
     std::string name = star::ConfigFile::getSetting(Config_Settings::app_name);
 
-    return StarWindow::Builder().setWidth(width).setHeight(height).setTitle(name).build();
+    return StarWindow::Builder()
+        .setWidth(width)
+        .setHeight(height)
+        .setTitle(name)
+        .setDisplayMode(m_winContext.displayMode)
+        .setMonitor(m_winContext.displayMonitorIndex)
+        .setRefreshRate(m_winContext.displayRefreshRate)
+        .build();
 }
 
 std::vector<const char *> EngineInitPolicy::getRequiredDisplayExtensions() const
@@ -93,7 +168,7 @@ void EngineInitPolicy::init(uint8_t requestedNumFramesInFlight)
 void EngineInitPolicy::getNumSupportedSwapchainImages(core::device::StarDevice &device, uint8_t &min,
                                                       uint8_t &max) const
 {
-    const auto result = device.getPhysicalDevice().getSurfaceCapabilities2KHR(m_winContext.surface.getVulkanSurface());
+    const auto &result = m_winContext.surface.getCapabilities(device.getPhysicalDevice());
 
     min = (uint8_t)result.surfaceCapabilities.minImageCount;
     max = (uint8_t)result.surfaceCapabilities.maxImageCount;
@@ -1,10 +1,60 @@
 #include "star_windowing/policy/EngineMainLoopPolicy.hpp"
 
+#include "star_windowing/InteractivityBus.hpp"
+
 namespace star::windowing
 {
 
 void EngineMainLoopPolicy::frameUpdate()
 {
-    glfwPollEvents();
+    // wait before pumping so the frame starts with the freshest input
+    m_frameRateLimiter.waitForNextFrame();
+
+    InteractivityBus::BeginInputFrame();
+
+    if (m_winContext.threadingMode == Threading_Mode::dedicated_render_thread)
+    {
+        // events are pumped by the main thread, only pick up what it has queued
+        InteractivityBus::DispatchQueuedInput();
+    }
+    else
+    {
+        pumpEvents();
+    }
+
+    InteractivityBus::EndInputFrame();
+}
+
+void EngineMainLoopPolicy::setRefreshFrame(std::function<void()> renderFrame)
+{
+    m_winContext.refreshFrame = std::move(renderFrame);
+
+    // a window which already exists will not pick the frame up from the context anymore
+    if (m_winContext.threadingMode == Threading_Mode::single_thread && m_winContext.window.getGLFWWindow() != nullptr)
+    {
+        m_winContext.window.setRefreshCallback(m_winContext.refreshFrame);
+    }
+}
+
+void EngineMainLoopPolicy::pumpEvents()
+{
+    if (m_winContext.window.isRefreshing())
+    {
+        // this frame is being rendered from inside the window refresh callback, GLFW is already pumping events
+        return;
+    }
+
+    switch (m_winContext.eventWaitMode)
+    {
+    case Event_Wait_Mode::poll:
+        glfwPollEvents();
+        break;
+    case Event_Wait_Mode::wait_timeout:
+        glfwWaitEventsTimeout(m_winContext.eventWaitTimeoutSeconds);
+        break;
+    case Event_Wait_Mode::wait:
+        glfwWaitEvents();
+        break;
+    }
 }
-} // namespace star::windowing
\ No newline at end of file
+} // namespace star::windowing
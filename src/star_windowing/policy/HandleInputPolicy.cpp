@@ -0,0 +1 @@
+#include "star_windowing/policy/HandleInputPolicy.hpp"
\ No newline at end of file
@@ -0,0 +1 @@
+#include "star_windowing/policy/HandleMouseDeltaPolicy.hpp"
\ No newline at end of file
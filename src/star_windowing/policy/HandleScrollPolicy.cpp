@@ -0,0 +1 @@
+#include "star_windowing/policy/HandleScrollPolicy.hpp"
\ No newline at end of file
@@ -5,6 +5,7 @@
 
 #include <cassert>
 #include <functional>
+#include <stdexcept>
 
 namespace star::windowing
 {
@@ -13,7 +14,8 @@ SwapChainControllerService::SwapChainControllerService(SwapChainControllerServic
     : ListenForRequestForSwapChainPolicy<SwapChainControllerService>{*this},
       star::policy::ListenForPrepForNextFramePolicy<SwapChainControllerService>{*this}, m_swapChain{std::move(other.m_swapChain)},
       m_listenerHandle{}, m_winContext{std::move(other.m_winContext)},
-      m_deviceEventBus{std::move(other.m_deviceEventBus)}, m_device{std::move(other.m_device)}
+      m_deviceEventBus{std::move(other.m_deviceEventBus)}, m_device{std::move(other.m_device)},
+      m_activeFramesInFlight{other.m_activeFramesInFlight}
 {
     if (m_deviceEventBus != nullptr)
     {
@@ -31,6 +33,7 @@ SwapChainControllerService &SwapChainControllerService::operator=(SwapChainContr
         m_deviceEventBus = std::move(other.m_deviceEventBus);
         m_deviceFrameTracker = std::move(other.m_deviceFrameTracker);
         m_device = std::move(other.m_device);
+        m_activeFramesInFlight = other.m_activeFramesInFlight;
 
         if (m_deviceEventBus != nullptr)
         {
@@ -59,6 +62,8 @@ void SwapChainControllerService::init(const uint8_t &numFramesInFlight)
 {
     assert(m_deviceEventBus != nullptr && m_deviceFrameTracker != nullptr);
 
+    m_activeFramesInFlight = getRequestedFramesInFlight(numFramesInFlight);
+
     m_swapChain = SwapChain(m_winContext);
     m_swapChain.prepRender(*m_device, *m_deviceEventBus, *m_deviceFrameTracker);
     initListeners(*m_deviceEventBus);
@@ -81,34 +86,133 @@ void SwapChainControllerService::shutdown()
 void SwapChainControllerService::prepForNextFrame(common::FrameTracker *frameTracker)
 {
     assert(m_device != nullptr && m_deviceFrameTracker != nullptr);
+    // a final compute pass was registered or removed, see WindowingContext::computeToSwapChain
+    if (shouldRebuildSwapChain() || m_swapChain.isStorageUsageOutdated())
+    {
+        rebuildSwapChain();
+    }
+
     // increment frame in flight index before handling next render to target image
     frameTracker->getCurrent().setFrameInFlightIndex(incrementNextFrameInFlight(*frameTracker));
     frameTracker->triggerIncrementForCurrentFrame();
+
+    if (m_winContext->damageTracking && !m_winContext->hasPendingDamage)
+    {
+        // nothing changed since the previous present, the image on screen is still current
+        m_swapChain.skipNextSwapChainImage(*m_device, *frameTracker);
+        frameTracker->getCurrent().setFinalTargetImageIndex(0);
+        return;
+    }
+
     frameTracker->getCurrent().setFinalTargetImageIndex(incrementNextSwapChainImage(*frameTracker));
 }
 
 uint8_t SwapChainControllerService::incrementNextSwapChainImage(const common::FrameTracker &frameTracker)
 {
-    const auto aResult = m_swapChain.acquireNextSwapChainImage(*m_device, frameTracker);
+    auto aResult = m_swapChain.acquireNextSwapChainImage(*m_device, frameTracker);
+
+    if (aResult.result == vk::Result::eErrorOutOfDateKHR && rebuildSwapChain())
+    {
+        // the old swapchain can no longer be presented to, this cannot wait for the resize to settle
+        aResult = m_swapChain.acquireNextSwapChainImage(*m_device, frameTracker);
+    }
 
     if (aResult.result == vk::Result::eErrorOutOfDateKHR)
     {
-        throw std::runtime_error("Swapchain is out of date and support for recreation is not implemented");
+        // minimized, or the surface changed again while rebuilding as it does in the middle of a drag. The frame is
+        // skipped and the next one tries again, any valid index will do as nothing is drawn to it
+        return 0;
+    }
+
+    if (aResult.result == vk::Result::eSuboptimalKHR)
+    {
+        m_isSwapChainSuboptimal = true;
     }
-    else if (aResult.result != vk::Result::eSuccess && aResult.result != vk::Result::eSuboptimalKHR)
+    else if (aResult.result != vk::Result::eSuccess)
     {
-        throw std::runtime_error("Failed to acquire swapchain image due to suboptimal khr layout");
+        throw std::runtime_error("Failed to acquire swapchain image");
     }
 
     return static_cast<uint8_t>(aResult.value);
 }
 
-uint8_t SwapChainControllerService::incrementNextFrameInFlight(const common::FrameTracker &frameTracker) const noexcept
+bool SwapChainControllerService::shouldRebuildSwapChain()
+{
+    assert(m_winContext != nullptr);
+
+    if (!m_winContext->window.wasWindowResized() && !m_isSwapChainSuboptimal)
+    {
+        return false;
+    }
+
+    // minimized, keep the current swapchain until there is something to present to
+    if (isWindowMinimized())
+    {
+        return false;
+    }
+
+    m_framesPresentedSinceResize++;
+
+    return m_winContext->window.getSecondsSinceLastResize() >= m_winContext->resizeSettleSeconds ||
+           m_framesPresentedSinceResize > m_winContext->resizeMaxDeferredFrames;
+}
+
+bool SwapChainControllerService::isWindowMinimized() const
+{
+    assert(m_winContext != nullptr);
+
+    const vk::Extent2D framebufferSize = m_winContext->window.getWindowFramebufferSize();
+    return framebufferSize.width == 0 || framebufferSize.height == 0;
+}
+
+bool SwapChainControllerService::rebuildSwapChain()
+{
+    assert(m_device != nullptr && m_deviceFrameTracker != nullptr);
+
+    // the surface extent is zero while minimized, which no swapchain can be created with
+    if (isWindowMinimized())
+    {
+        return false;
+    }
+
+    // cleared first so a resize arriving during the rebuild triggers another one
+    m_winContext->window.resetWindowResizedFlag();
+    m_isSwapChainSuboptimal = false;
+    m_framesPresentedSinceResize = 0;
+
+    m_swapChain.recreate(*m_device, *m_deviceFrameTracker);
+    // the new images hold nothing yet
+    m_winContext->hasPendingDamage = true;
+    return true;
+}
+
+uint8_t SwapChainControllerService::incrementNextFrameInFlight(const common::FrameTracker &frameTracker) noexcept
 {
     const uint8_t &max = frameTracker.getSetup().getNumFramesInFlight();
     const uint8_t &current = frameTracker.getCurrent().getFrameInFlightIndex();
 
-    return (current + 1) % max;
+    const uint8_t next = current + 1;
+    if (next < m_activeFramesInFlight)
+    {
+        return next;
+    }
+
+    // the count only changes where the cycle starts over. Everything is allocated for the max, so frames dropped by a
+    // lower count simply sit idle, and their fence is waited on as usual once a higher count brings them back
+    m_activeFramesInFlight = getRequestedFramesInFlight(max);
+    return 0;
+}
+
+uint8_t SwapChainControllerService::getRequestedFramesInFlight(const uint8_t &maxFramesInFlight) const noexcept
+{
+    assert(m_winContext != nullptr);
+
+    const uint8_t requested = m_winContext->activeFramesInFlight;
+    if (requested == 0 || requested > maxFramesInFlight)
+    {
+        return maxFramesInFlight;
+    }
+    return requested;
 }
 
 } // namespace star::windowing
\ No newline at end of file